@@ -121,9 +121,11 @@
 #include <metaverse/bitcoin/utility/enable_shared_from_base.hpp>
 #include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/exceptions.hpp>
+#include <metaverse/bitcoin/utility/hash_cache.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/log.hpp>
 #include <metaverse/bitcoin/utility/logging.hpp>
+#include <metaverse/bitcoin/utility/metrics.hpp>
 #include <metaverse/bitcoin/utility/monitor.hpp>
 #include <metaverse/bitcoin/utility/notifier.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
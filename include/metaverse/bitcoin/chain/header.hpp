@@ -31,6 +31,7 @@
 #include <metaverse/bitcoin/define.hpp>
 #include <metaverse/bitcoin/math/hash.hpp>
 #include <metaverse/bitcoin/utility/data.hpp>
+#include <metaverse/bitcoin/utility/hash_cache.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
 #include <metaverse/bitcoin/utility/thread.hpp>
 #include <metaverse/bitcoin/utility/writer.hpp>
@@ -105,8 +106,7 @@ public:
     uint64_t transaction_count;
 
 private:
-    mutable upgrade_mutex mutex_;
-    mutable std::shared_ptr<hash_digest> hash_;
+    hash_cache hash_;
 };
 
 BC_API bool operator==(const header& left, const header& right);
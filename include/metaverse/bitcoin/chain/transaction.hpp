@@ -30,6 +30,7 @@
 #include <metaverse/bitcoin/chain/input.hpp>
 #include <metaverse/bitcoin/chain/output.hpp>
 #include <metaverse/bitcoin/math/elliptic_curve.hpp>
+#include <metaverse/bitcoin/utility/hash_cache.hpp>
 #include <metaverse/bitcoin/utility/reader.hpp>
 #include <metaverse/bitcoin/utility/thread.hpp>
 #include <metaverse/bitcoin/utility/writer.hpp>
@@ -104,8 +105,7 @@ public:
     output::list outputs;
 
 private:
-    mutable upgrade_mutex mutex_;
-    mutable std::shared_ptr<hash_digest> hash_;
+    hash_cache hash_;
 };
 
 } // namespace chain
@@ -182,6 +182,16 @@ BC_API long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
  */
 BC_API hash_digest bitcoin_hash(data_slice data);
 
+/**
+ * Generate the bitcoin hashes of consecutive pairs of hashes, as used in the
+ * levels of a merkle tree. Several pairs are hashed at once on processors
+ * with vector extensions. The output may be the same as the input.
+ *
+ * out[i] = sha256(sha256(in[2i] + in[2i + 1]))
+ */
+BC_API void bitcoin_hash_pairs(hash_digest* out, const hash_digest* in,
+    size_t pairs);
+
 /**
  * Generate a bitcoin short hash. This hash function is used in a
  * few specific cases where short hashes are desired.
@@ -190,6 +200,14 @@ BC_API hash_digest bitcoin_hash(data_slice data);
  */
 BC_API short_hash bitcoin_short_hash(data_slice data);
 
+/**
+ * Generate a siphash-2-4 hash. This keyed hash function is used in bip152
+ * compact block short transaction ids.
+ *
+ * siphash-2-4(k0, k1, data)
+ */
+BC_API uint64_t siphash24(uint64_t k0, uint64_t k1, data_slice data);
+
 /**
  * Generate a scrypt hash of specified length.
  *
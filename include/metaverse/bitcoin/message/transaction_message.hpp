@@ -76,12 +76,18 @@ public:
     uint64_t originator() const;
     void set_originator(uint64_t value);
 
+    /// The fee paid, known once the transaction is validated against its
+    /// previous outputs, otherwise zero.
+    uint64_t fee() const;
+    void set_fee(uint64_t value);
+
     static const std::string command;
     static const uint32_t version_minimum;
     static const uint32_t version_maximum;
 
 private:
     uint64_t originator_;
+    uint64_t fee_;
 };
 
 } // namespace message
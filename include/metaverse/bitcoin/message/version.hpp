@@ -70,7 +70,7 @@ public:
         minimum = 31402,
 
         // We support at most this internally (bound to settings default).
-        maximum = bip130
+        maximum = bip152
     };
 
     static version factory_from_data(uint32_t version, const data_chunk& data);
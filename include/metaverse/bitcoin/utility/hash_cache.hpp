@@ -0,0 +1,64 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_HASH_CACHE_HPP
+#define MVS_HASH_CACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/math/hash.hpp>
+
+namespace libbitcoin {
+
+/// A lazily set hash that may be read and set concurrently without a lock.
+/// Concurrent first readers may each compute the hash, the first to finish
+/// stores it. Copies start empty, as the copy may be changed before it is
+/// hashed. Reset is not safe concurrently with get or set.
+class BC_API hash_cache
+{
+public:
+    hash_cache();
+    hash_cache(const hash_cache& other);
+    hash_cache& operator=(const hash_cache& other);
+
+    /// True and the hash if it has been set.
+    bool get(hash_digest& out) const;
+
+    /// Store the hash unless already set.
+    void set(const hash_digest& hash) const;
+
+    /// Discard the hash, after a change to the hashed object.
+    void reset();
+
+private:
+    enum state : uint8_t
+    {
+        empty,
+        writing,
+        ready
+    };
+
+    mutable std::atomic<uint8_t> state_;
+    mutable hash_digest hash_;
+};
+
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_METRICS_HPP
+#define MVS_METRICS_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <metaverse/bitcoin/define.hpp>
+#include <metaverse/bitcoin/utility/thread.hpp>
+
+namespace libbitcoin {
+
+/// A monotonic counter, updates are lock free.
+class BC_API metric_counter
+{
+public:
+    metric_counter();
+
+    void increment(uint64_t amount=1)
+    {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+    void write(std::ostream& out, const std::string& name,
+        const std::string& labels) const;
+
+private:
+    std::atomic<uint64_t> value_;
+};
+
+/// A value that can go up and down, updates are lock free.
+class BC_API metric_gauge
+{
+public:
+    metric_gauge();
+
+    void set(int64_t value)
+    {
+        value_.store(value, std::memory_order_relaxed);
+    }
+
+    void add(int64_t amount)
+    {
+        value_.fetch_add(amount, std::memory_order_relaxed);
+    }
+
+    int64_t value() const;
+    void write(std::ostream& out, const std::string& name,
+        const std::string& labels) const;
+
+private:
+    std::atomic<int64_t> value_;
+};
+
+/// Observations counted into fixed buckets, updates are lock free.
+class BC_API metric_histogram
+{
+public:
+    typedef std::vector<double> bounds;
+
+    /// Upper bounds in seconds, suitable for latencies.
+    static const bounds seconds;
+
+    metric_histogram(const bounds& upper_bounds=seconds);
+
+    void observe(double value);
+
+    /// Observe a duration in seconds.
+    template <typename Duration>
+    void observe_duration(const Duration& duration)
+    {
+        observe(std::chrono::duration<double>(duration).count());
+    }
+
+    uint64_t count() const;
+    double sum() const;
+    void write(std::ostream& out, const std::string& name,
+        const std::string& labels) const;
+
+private:
+    const bounds bounds_;
+    std::unique_ptr<std::atomic<uint64_t>[]> buckets_;
+    std::atomic<uint64_t> count_;
+    std::atomic<double> sum_;
+};
+
+/// The metrics of one name, one per value of an optional label.
+class BC_API metric_family_base
+{
+public:
+    metric_family_base(const std::string& name, const std::string& help,
+        const std::string& type, const std::string& label);
+    virtual ~metric_family_base();
+
+    const std::string& type() const;
+    void write(std::ostream& out) const;
+
+protected:
+    virtual void write_values(std::ostream& out) const = 0;
+    std::string labels(const std::string& value) const;
+
+    const std::string name_;
+    const std::string help_;
+    const std::string type_;
+    const std::string label_;
+};
+
+template <typename Metric>
+class metric_family
+  : public metric_family_base
+{
+public:
+    typedef std::function<Metric*()> factory;
+
+    metric_family(const std::string& name, const std::string& help,
+        const std::string& type, const std::string& label, factory make)
+      : metric_family_base(name, help, type, label), make_(make)
+    {
+    }
+
+    /// The metric for the label value, created on first use. Callers on
+    /// hot paths should keep the returned reference, it remains valid for
+    /// the life of the process.
+    Metric& get(const std::string& value="")
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        {
+            shared_lock lock(mutex_);
+            const auto it = metrics_.find(value);
+            if (it != metrics_.end())
+                return *it->second;
+        }
+
+        unique_lock lock(mutex_);
+        auto& metric = metrics_[value];
+        if (!metric)
+            metric.reset(make_());
+
+        return *metric;
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+protected:
+    void write_values(std::ostream& out) const override
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        shared_lock lock(mutex_);
+
+        for (const auto& metric: metrics_)
+            metric.second->write(out, name_, labels(metric.first));
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+private:
+    const factory make_;
+    std::map<std::string, std::unique_ptr<Metric>> metrics_;
+    mutable shared_mutex mutex_;
+};
+
+/// Process wide registry of named metrics, rendered in the prometheus text
+/// exposition format. Registration locks, metric updates do not.
+class BC_API metrics
+{
+public:
+    typedef metric_family<metric_counter> counter_family;
+    typedef metric_family<metric_gauge> gauge_family;
+    typedef metric_family<metric_histogram> histogram_family;
+
+    /// Get or register a family, the label name is empty for no label.
+    static counter_family& counter(const std::string& name,
+        const std::string& help, const std::string& label="");
+    static gauge_family& gauge(const std::string& name,
+        const std::string& help, const std::string& label="");
+    static histogram_family& histogram(const std::string& name,
+        const std::string& help, const std::string& label="",
+        const metric_histogram::bounds& bounds=metric_histogram::seconds);
+
+    /// All registered metrics in prometheus text format.
+    static std::string to_text();
+
+private:
+    static metric_family_base& find(const std::string& name,
+        std::function<metric_family_base*()> make);
+};
+
+} // namespace libbitcoin
+
+#endif
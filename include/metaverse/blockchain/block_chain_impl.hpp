@@ -31,6 +31,7 @@
 #include <metaverse/blockchain/block_chain.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/organizer.hpp>
+#include <metaverse/blockchain/script_cache.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
@@ -67,6 +68,9 @@ public:
     // Get a reference to the transaction pool.
     transaction_pool& pool();
 
+    // Get a reference to the input scripts verified by the pool.
+    script_cache& verified_scripts();
+
     // Get a reference to the blockchain configuration settings.
     const settings& chain_settings() const;
 
@@ -384,6 +388,7 @@ private:
     ////dispatcher read_dispatch_;
     ////dispatcher write_dispatch_;
     blockchain::transaction_pool transaction_pool_;
+    script_cache verified_scripts_;
 
     // This is protected by mutex.
     database::data_base database_;
@@ -61,7 +61,8 @@ public:
     //chenhao remove & from hash_digest
     const hash_digest hash() const;
 
-    // Set if work proof is checked.
+    // Set once the block passes verify, so that it is not verified again
+    // when its fork grows or is traced again from the pool.
     void set_is_checked_work_proof(bool is_checked);
     bool get_is_checked_work_proof() const;
 
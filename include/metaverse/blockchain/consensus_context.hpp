@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_CONSENSUS_CONTEXT_HPP
+#define MVS_BLOCKCHAIN_CONSENSUS_CONTEXT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace consensus {
+class transaction_context;
+} // namespace consensus
+
+namespace blockchain {
+
+/// Script verification state of one transaction, shared by the checks of
+/// all of its inputs so the transaction is serialized and parsed once.
+/// The transaction must outlive the context. This class is not thread safe.
+class BCB_API consensus_context
+{
+public:
+    consensus_context(const chain::transaction& tx);
+    ~consensus_context();
+
+    /// This class is not copyable.
+    consensus_context(const consensus_context&) = delete;
+    void operator=(const consensus_context&) = delete;
+
+    const chain::transaction& transaction() const;
+
+    /// Verify the input script against the previous output script.
+    bool verify(const chain::script& prevout_script, size_t input_index,
+        uint32_t flags) const;
+
+private:
+    const chain::transaction& tx_;
+
+    // Created on first verification when built with consensus verification.
+    mutable std::unique_ptr<consensus::transaction_context> context_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
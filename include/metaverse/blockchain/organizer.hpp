@@ -84,6 +84,8 @@ private:
         const block_detail::list& orphan_chain, uint64_t orphan_index);
     void process(block_detail::ptr process_block);
     void replace_chain(uint64_t fork_index, detail_list& orphan_chain);
+    bool insufficient_work(detail_list& orphan_chain, uint64_t begin_index,
+        const u256& orphan_work, const u256& main_work);
     void remove_processed(block_detail::ptr remove_block);
     void clip_orphans(detail_list& orphan_chain, uint64_t orphan_index,
         const code& invalid_reason);
@@ -22,8 +22,11 @@
 #define MVS_BLOCKCHAIN_orphan_pool_HPP
 
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <memory>
-#include <boost/circular_buffer.hpp>
+#include <unordered_map>
+#include <unordered_set>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_detail.hpp>
@@ -32,7 +35,8 @@ namespace libbitcoin {
 namespace blockchain {
 
 /// This class is thread safe.
-/// An unordered memory pool for orphan blocks.
+/// A memory pool for orphan blocks indexed by hash. When the pool is at
+/// capacity the earliest arrival is evicted to make room.
 class BCB_API orphan_pool
 {
 public:
@@ -59,22 +63,31 @@ public:
     block_detail::ptr delete_pending_block(const hash_digest& needed_block);
 
 private:
-//    typedef boost::circular_buffer<block_detail::ptr> buffer;
-    typedef std::vector<block_detail::ptr> buffer;
-    typedef buffer::const_iterator const_iterator;
-    typedef buffer::const_reverse_iterator const_reverse_iterator;
+    struct entry
+    {
+        block_detail::ptr block;
+        uint64_t sequence;
+    };
+
+    typedef std::unordered_map<hash_digest, entry> entries;
+    typedef std::map<uint64_t, block_detail::ptr> arrivals;
+    typedef std::unordered_multimap<hash_digest, block_detail::ptr> pendings;
 
     bool exists(const hash_digest& hash) const;
-    bool exists(const chain::header& header) const;
-    const_iterator find(buffer::const_iterator begin, const hash_digest& hash) const;
-    const_reverse_iterator rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const;
+    void erase(entries::iterator it);
+
+    const size_t capacity_;
+    uint64_t sequence_;
 
-    // The buffer is protected by mutex.
-    buffer buffer_;
+    // The indexes are protected by mutex.
+    entries entries_;
+    arrivals arrivals_;
+    mutable arrivals unprocessed_;
     mutable upgrade_mutex mutex_;
 
-    std::multimap<hash_digest, block_detail::ptr> pending_blocks_;
-    std::set<hash_digest> pending_blocks_hash_;
+    // Tips of traced chains keyed by the missing parent of the chain root.
+    pendings pending_blocks_;
+    std::unordered_set<hash_digest> pending_blocks_hash_;
 };
 
 } // namespace blockchain
@@ -0,0 +1,73 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_BLOCKCHAIN_SCRIPT_CACHE_HPP
+#define MVS_BLOCKCHAIN_SCRIPT_CACHE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/define.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+/// A bounded cache of input scripts that have been verified, populated by
+/// mempool validation and consumed by block validation so transactions
+/// already seen are not verified again when they arrive in a block.
+/// This class is thread safe.
+class BCB_API script_cache
+{
+public:
+    script_cache(size_t capacity);
+
+    /// This class is not copyable.
+    script_cache(const script_cache&) = delete;
+    void operator=(const script_cache&) = delete;
+
+    /// Record that the input script verified under the script flags.
+    void store(const chain::input_point& input, uint32_t flags);
+
+    /// True if the input script verified under all of the script flags,
+    /// removing the entry as it is not expected to be needed again.
+    bool take(const chain::input_point& input, uint32_t flags);
+
+    size_t size() const;
+
+private:
+    struct shard
+    {
+        mutable shared_mutex mutex;
+        std::unordered_map<chain::input_point, uint32_t> flags;
+        std::deque<chain::input_point> order;
+    };
+
+    shard& find_shard(const chain::input_point& input);
+
+    const size_t shard_capacity_;
+    std::vector<shard> shards_;
+};
+
+} // namespace blockchain
+} // namespace libbitcoin
+
+#endif
@@ -40,6 +40,9 @@ public:
     uint32_t block_pool_capacity;
     uint32_t transaction_pool_capacity;
     bool transaction_pool_consistency;
+    boost::filesystem::path transaction_pool_file;
+    uint32_t transaction_pool_snapshot_minutes;
+    uint32_t script_cache_capacity;
     bool use_testnet_rules;
     config::checkpoint::list checkpoints;
 };
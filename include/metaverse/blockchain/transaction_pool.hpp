@@ -24,6 +24,8 @@
 #include <atomic>
 #include <cstddef>
 #include <functional>
+#include <iostream>
+#include <vector>
 #include <boost/circular_buffer.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
@@ -95,11 +97,14 @@ protected:
     {
         transaction_ptr tx;
         confirm_handler handle_confirm;
+        indexes unconfirmed;
+        uint32_t arrival;
     };
 
     typedef boost::circular_buffer<entry> buffer;
     typedef buffer::const_iterator const_iterator;
 
+    typedef std::vector<entry> entry_list;
     typedef std::function<bool(const chain::input&)> input_compare;
     typedef message::block_message::ptr_list block_list;
 
@@ -112,14 +117,28 @@ protected:
         const indexes& unconfirmed, validate_handler handler);
 
     void do_validate(transaction_ptr tx, validate_handler handler);
+    void store(transaction_ptr tx, uint32_t arrival,
+        confirm_handler handle_confirm, validate_handler handle_validate);
     void do_store(const code& ec, transaction_ptr tx,
         const indexes& unconfirmed, confirm_handler handle_confirm,
-        validate_handler handle_validate);
+        validate_handler handle_validate, uint32_t arrival);
+
+    bool load(std::istream& file, entry_list& out_entries,
+        bool& out_same_tip) const;
+    void save(std::ostream& file) const;
+    void save_snapshot();
+    void restore(std::shared_ptr<entry_list> entries, size_t position,
+        bool same_tip);
+    void handle_restored(const code& ec, transaction_ptr tx,
+        std::shared_ptr<entry_list> entries, size_t position, bool same_tip);
+    void handle_snapshot_timer(const code& ec);
+    bool get_tip(uint64_t& out_height, hash_digest& out_hash) const;
 
     void notify_transaction(const chain::point::indexes& unconfirmed,
         transaction_ptr tx);
 
-    void add(transaction_ptr tx, confirm_handler handler);
+    void add(transaction_ptr tx, const indexes& unconfirmed,
+        confirm_handler handler, uint32_t arrival);
     void remove(const block_list& blocks);
     void clear(const code& ec);
 
@@ -152,11 +171,15 @@ private:
     bool find(chain::transaction& out_tx, const hash_digest& tx_hash) const;
 
     // These are thread safe.
+    threadpool& pool_;
     dispatcher dispatch_;
     block_chain& blockchain_;
     transaction_pool_index index_;
     transaction_subscriber::ptr subscriber_;
     const bool maintain_consistency_;
+    const boost::filesystem::path file_path_;
+    const asio::duration snapshot_interval_;
+    deadline::ptr snapshot_timer_;
 };
 
 } // namespace blockchain
@@ -28,6 +28,7 @@
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/consensus_context.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -73,10 +74,12 @@ protected:
     virtual bool is_output_spent(const chain::output_point& outpoint) const = 0;
     virtual bool is_output_spent(const chain::output_point& previous_output,
         size_t index_in_parent, size_t input_index) const = 0;
+    virtual bool is_script_verified(const chain::input_point& input,
+        uint32_t flags) const = 0;
 
     // These have default implementations that can be overriden.
     virtual bool connect_input(size_t index_in_parent,
-        const chain::transaction& current_tx, size_t input_index,
+        const consensus_context& context, size_t input_index,
         uint64_t& value_in, size_t& total_sigops) const;
     virtual bool validate_inputs(const chain::transaction& tx,
         size_t index_in_parent, uint64_t& value_in,
@@ -92,6 +95,8 @@ protected:
     bool check_time_stamp(uint32_t timestamp, const asio::seconds& window) const;
     u256 work_required(bool is_testnet) const;
 
+    static code check_coinbases(const chain::transaction::list& txs,
+        const stopped_callback& stopped);
     static bool is_distinct_tx_set(const chain::transaction::list& txs);
     virtual bool is_valid_proof_of_work(const chain::header& header)const = 0;
     static bool is_valid_coinbase_height(size_t height,
@@ -56,6 +56,8 @@ protected:
     bool is_output_spent(const chain::output_point& previous_output,
         size_t index_in_parent, size_t input_index) const;
     bool transaction_exists(const hash_digest& tx_hash) const;
+    bool is_script_verified(const chain::input_point& input,
+        uint32_t flags) const;
 
 private:
     bool fetch_orphan_transaction(chain::transaction& tx,
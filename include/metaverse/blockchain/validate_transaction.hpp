@@ -26,6 +26,7 @@
 #include <functional>
 #include <memory>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/consensus_context.hpp>
 #include <metaverse/blockchain/define.hpp>
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/blockchain/block_chain_impl.hpp>
@@ -56,6 +57,11 @@ public:
         const chain::transaction& current_tx, size_t input_index,
         uint32_t flags);
 
+    /// Check against the shared verification state of the transaction.
+    static bool check_consensus(const chain::script& prevout_script,
+        const consensus_context& context, size_t input_index,
+        uint32_t flags);
+
     static code check_transaction(
         const chain::transaction& tx, blockchain::block_chain_impl& chain);
     static code check_transaction_basic(
@@ -85,7 +91,7 @@ public:
         const output& output);
 
     static bool connect_input(const chain::transaction& tx,
-        size_t current_input, const chain::transaction& previous_tx,
+        const consensus_context& context, size_t current_input, const chain::transaction& previous_tx,
         size_t parent_height, size_t last_block_height, uint64_t& value_in,
         uint32_t flags, uint64_t& asset_amount_in,
         std::vector<asset_cert_type>& asset_certs_in,
@@ -132,6 +138,7 @@ private:
     dispatcher& dispatch_;
 
     const hash_digest tx_hash_;
+    const consensus_context context_;
     size_t last_block_height_;
     uint64_t value_in_;
     uint64_t asset_amount_in_;
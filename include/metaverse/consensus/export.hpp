@@ -22,6 +22,7 @@
 #define MVS_CONSENSUS_EXPORT_HPP
 
 #include <cstddef>
+#include <memory>
 #include <metaverse/consensus/define.hpp>
 #include <metaverse/consensus/version.hpp>
 
@@ -194,6 +195,46 @@ typedef enum verify_flags_type
     size_t prevout_script_size, unsigned int tx_input_index, 
     unsigned int flags);
 
+/**
+ * A transaction parsed once for the verification of all of its inputs.
+ * The parsed transaction and the serialization and hash state of the
+ * signature hash prefix are cached, so verifying n inputs does not parse
+ * and serialize the transaction n times. This class is not thread safe.
+ */
+class BCK_API transaction_context
+{
+public:
+    /**
+     * @param[in]  transaction       The transaction with the scripts to verify.
+     * @param[in]  transaction_size  The byte length of the transaction.
+     */
+    transaction_context(const unsigned char* transaction,
+        size_t transaction_size);
+    ~transaction_context();
+
+    /// This class is not copyable.
+    transaction_context(const transaction_context&) = delete;
+    void operator=(const transaction_context&) = delete;
+
+    /**
+     * Verify that the transaction input correctly spends the previous output,
+     * equivalent to verify_script with the transaction of this context.
+     * @param[in]  prevout_script      The script public key to verify against.
+     * @param[in]  prevout_script_size The byte length of the script public key.
+     * @param[in]  tx_input_index      The zero-based index of the transaction
+     *                                 input with signature to be verified.
+     * @param[in]  flags               Verification constraint flags.
+     * @returns                        A script verification result code.
+     */
+    verify_result_type verify_script(const unsigned char* prevout_script,
+        size_t prevout_script_size, unsigned int tx_input_index,
+        unsigned int flags) const;
+
+private:
+    class implementation;
+    std::unique_ptr<implementation> implementation_;
+};
+
 } // namespace consensus
 } // namespace libbitcoin
 
@@ -21,6 +21,8 @@
 #ifndef MVS_CONSENSUS_MINER_HPP
 #define MVS_CONSENSUS_MINER_HPP
 
+#include <atomic>
+#include <mutex>
 #include <vector>
 #include <boost/thread.hpp>
 
@@ -66,6 +68,32 @@ public:
     // tx_hash -> tx_fee
     typedef std::unordered_map<hash_digest, uint64_t> tx_fee_map_t;
 
+    // tx_hash -> pool transaction
+    typedef std::unordered_map<hash_digest, transaction_ptr> transaction_map_t;
+
+    typedef message::block_message::ptr_list block_list;
+    typedef blockchain::transaction_pool::indexes index_list;
+
+    // Block template candidate, prepared once when the tx enters the pool
+    // and reused by every template build until the tx or its parents change.
+    struct template_entry
+    {
+        transaction_ptr tx;
+        uint64_t fee;
+        uint64_t serialized_size;
+        size_t sigops;
+
+        // sum(value) and sum(value * height) over confirmed inputs,
+        // so that coin age priority is computed in constant time.
+        double confirmed_value;
+        double confirmed_value_height;
+
+        // unconfirmed parents in pool, one per spending input.
+        std::vector<hash_digest> parents;
+    };
+    typedef std::shared_ptr<template_entry> template_entry_ptr;
+    typedef std::unordered_map<hash_digest, template_entry_ptr> template_cache_t;
+
     miner(p2p_node& node);
     ~miner();
 
@@ -104,10 +132,15 @@ private:
     block_ptr create_new_block(const wallet::payment_address& pay_addres);
     unsigned int get_adjust_time(uint64_t height) const;
     unsigned int get_median_time_past(uint64_t height) const;
-    bool get_transaction(std::vector<transaction_ptr>&, previous_out_map_t&, tx_fee_map_t&) const;
+    void get_template_entries(std::vector<template_entry_ptr>& entries);
+    template_entry_ptr prepare_template_entry(transaction_ptr tx,
+        const transaction_map_t& pool_txs, bool& invalid) const;
+    void subscribe_template_updates();
+    bool handle_pool_transaction(const code& ec, const index_list&, transaction_ptr tx);
+    bool handle_reorganized(const code& ec, size_t fork_point,
+        const block_list& new_blocks, const block_list& replaced_blocks);
     uint64_t store_block(block_ptr block);
     uint64_t get_height() const;
-    bool get_input_etp(const transaction&, const std::vector<transaction_ptr>&, uint64_t&, previous_out_map_t&) const ;
     bool is_stop_miner(uint64_t block_height) const;
 
 private:
@@ -118,8 +151,13 @@ private:
     uint16_t new_block_limit_;
 
     block_ptr new_block_;
+    std::mutex new_block_mutex_;
     wallet::payment_address pay_address_;
     const blockchain::settings& setting_;
+
+    template_cache_t template_cache_;
+    std::mutex template_mutex_;
+    std::atomic<bool> template_subscribed_;
 };
 
 }
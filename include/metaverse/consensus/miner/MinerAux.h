@@ -23,6 +23,11 @@ public:
 	static LightType get_light(h256& _seedHash);
 	static FullType get_full(h256& _seedHash);
 	static bool verifySeal(chain::header& header,chain::header& _parent);
+	/// Verify nonce and mixhash of header against a share boundary.
+	static bool verify(chain::header& header, h256 const& _boundary);
+	/// Batch form of verify, all headers must share one seed hash.
+	/// Outputs the ethash value of each header, or the max value on mixhash mismatch.
+	static void verify(std::vector<chain::header>& headers, std::vector<h256>& values);
 	static bool search(chain::header& header, std::function<bool (void)> is_exit);
     static uint64_t getRate(){ return get()->m_rate; }
 
@@ -24,6 +24,7 @@
 #include <metaverse/database/databases/spend_database.hpp>
 #include <metaverse/database/databases/stealth_database.hpp>
 #include <metaverse/database/databases/transaction_database.hpp>
+#include <metaverse/database/databases/undo_database.hpp>
 #include <metaverse/database/memory/accessor.hpp>
 #include <metaverse/database/memory/allocator.hpp>
 #include <metaverse/database/memory/memory.hpp>
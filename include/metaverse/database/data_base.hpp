@@ -23,7 +23,9 @@
 
 #include <atomic>
 #include <cstddef>
+#include <functional>
 #include <memory>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/interprocess/sync/file_lock.hpp>
 #include <metaverse/bitcoin.hpp>
@@ -32,6 +34,7 @@
 #include <metaverse/database/databases/transaction_database.hpp>
 #include <metaverse/database/databases/history_database.hpp>
 #include <metaverse/database/databases/stealth_database.hpp>
+#include <metaverse/database/databases/undo_database.hpp>
 #include <metaverse/database/define.hpp>
 #include <metaverse/database/settings.hpp>
 
@@ -82,6 +85,8 @@ public:
         bool certs_exist() const;
         bool touch_mits() const;
         bool mits_exist() const;
+        bool touch_undos() const;
+        bool undos_exist() const;
 
         path database_lock;
         path blocks_lookup;
@@ -110,6 +115,8 @@ public:
         path address_mits_rows;
         path mit_history_lookup;
         path mit_history_rows;
+        path undos_even_lookup;
+        path undos_odd_lookup;
     };
 
     class db_metadata
@@ -158,6 +165,7 @@ public:
     bool create_dids();
     bool create_certs();
     bool create_mits();
+    bool create_undos();
 
     /// Start all databases.
     bool start();
@@ -304,18 +312,22 @@ public:
    /* begin store asset info into  database */
 
 protected:
-    data_base(const store& paths, size_t history_height, size_t stealth_height);
-    data_base(const path& prefix, size_t history_height, size_t stealth_height);
+    data_base(const store& paths, size_t history_height, size_t stealth_height,
+        size_t write_threads=0);
+    data_base(const path& prefix, size_t history_height, size_t stealth_height,
+        size_t write_threads=0);
 
 private:
     typedef chain::input::list inputs;
     typedef chain::output::list outputs;
     typedef std::atomic<size_t> sequential_lock;
     typedef boost::interprocess::file_lock file_lock;
+    typedef std::vector<std::function<void()>> write_list;
 
     static bool initialize_dids(const path& prefix);
     static bool initialize_certs(const path& prefix);
     static bool initialize_mits(const path& prefix);
+    static bool initialize_undos(const path& prefix);
 
     static void uninitialize_lock(const path& lock);
     static file_lock initialize_lock(const path& lock);
@@ -325,18 +337,24 @@ private:
     void synchronize_certs();
     void synchronize_mits();
 
-    void push_inputs(const hash_digest& tx_hash, size_t height,
-        const inputs& inputs);
-    void push_outputs(const hash_digest& tx_hash, size_t height,
-        const outputs& outputs);
+    void write(const write_list& writes);
+    void push_spends(const hash_digest& tx_hash, const inputs& inputs);
+    void push_history(const hash_digest& tx_hash, size_t height,
+        const chain::transaction& tx);
+    void push_assets(const hash_digest& tx_hash, size_t height,
+        const chain::transaction& tx);
     void push_stealth(const hash_digest& tx_hash, size_t height,
         const outputs& outputs);
-    void pop_inputs(const inputs& inputs, size_t height);
-    void pop_outputs(const outputs& outputs, size_t height);
+    void journal_inputs(undo_entry::list& journal, size_t height,
+        const inputs& inputs) const;
+    void journal_outputs(undo_entry::list& journal, size_t height,
+        const outputs& outputs) const;
+    void undo(const undo_entry::list& journal);
 
     const path lock_file_path_;
     const size_t history_height_;
     const size_t stealth_height_;
+    const size_t write_threads_;
 
     // Atomic counter for implementing the sequential lock pattern.
     sequential_lock sequential_lock_;
@@ -350,6 +368,9 @@ private:
     // temp block timestamp
     uint32_t timestamp_;
 
+    // Applies the writes of a block to the databases in parallel.
+    threadpool writers_;
+
 public:
 
     /// Individual database query engines.
@@ -371,6 +392,7 @@ public:
     blockchain_mit_database mits;
     address_mit_database address_mits;
     mit_history_database mit_history;
+    undo_database undos;
 };
 
 } // namespace database
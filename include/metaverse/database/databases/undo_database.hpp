@@ -0,0 +1,163 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_DATABASE_UNDO_DATABASE_HPP
+#define MVS_DATABASE_UNDO_DATABASE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/define.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/slab_hash_table.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+/// One index row written by a block push, removed again when it is popped.
+struct BCD_API undo_entry
+{
+    enum class kind : uint8_t
+    {
+        /// The spend of the output point (hash, index).
+        spend,
+
+        /// The last history row of the address.
+        history,
+
+        /// The last address asset row of the address.
+        address_asset,
+
+        /// The asset of the symbol hash.
+        asset,
+
+        /// The last address did row of the address.
+        address_did,
+
+        /// The did of the symbol hash.
+        did,
+
+        /// The did transfer of the symbol hash to the address.
+        did_transfer,
+
+        /// The cert of the key hash.
+        cert,
+
+        /// The last address mit row of the address.
+        address_mit,
+
+        /// The last mit history row of the symbol, keyed in address.
+        mit_history,
+
+        /// The mit of the symbol hash.
+        mit
+    };
+
+    typedef std::vector<undo_entry> list;
+
+    undo_entry()
+      : undo_entry(kind::spend, null_short_hash)
+    {
+    }
+
+    /// Unused keys are zero, see kind for the keys of each row.
+    undo_entry(kind action, const short_hash& address,
+        const hash_digest& hash=null_hash, uint32_t index=0)
+      : action(action), address(address), hash(hash), index(index)
+    {
+    }
+
+    kind action;
+    short_hash address;
+    hash_digest hash;
+    uint32_t index;
+};
+
+/// The rows written by each block push, keyed by block hash, so that a pop
+/// removes exactly those rows without deriving them from the transactions.
+/// Only the journals of recent blocks are kept, in two tables that take turns
+/// every undo_depth blocks. The table being entered is cleared and its space
+/// reused, so at least the last undo_depth blocks have a journal.
+class BCD_API undo_database
+{
+public:
+    /// Construct the database from the files of the two tables.
+    undo_database(const boost::filesystem::path& even_filename,
+        const boost::filesystem::path& odd_filename,
+        std::shared_ptr<shared_mutex> mutex=nullptr);
+
+    /// Close the database (all threads must first be stopped).
+    ~undo_database();
+
+    /// Initialize a new undo database.
+    bool create();
+
+    /// Call before using the database.
+    bool start();
+
+    /// Call to signal a stop of current operations.
+    bool stop();
+
+    /// Call to unload the memory map.
+    bool close();
+
+    /// The journal of the block, null if it was pushed without one.
+    std::shared_ptr<undo_entry::list> get(const hash_digest& block_hash) const;
+
+    /// Store the journal of a block, in the order the rows were written.
+    void store(size_t height, const hash_digest& block_hash,
+        const undo_entry::list& journal);
+
+    /// Delete the journal of a block.
+    void remove(const hash_digest& block_hash);
+
+    /// Synchronise storage with disk so things are consistent.
+    /// Should be done at the end of every block write.
+    void sync();
+
+private:
+    typedef slab_hash_table<hash_digest> slab_map;
+
+    // Hash table used for looking up journals by block hash.
+    struct table
+    {
+        table(const boost::filesystem::path& map_filename,
+            std::shared_ptr<shared_mutex> mutex);
+
+        bool create();
+        bool start();
+        void clear();
+
+        memory_map lookup_file;
+        slab_hash_table_header lookup_header;
+        slab_manager lookup_manager;
+        slab_map lookup_map;
+    };
+
+    table tables_[2];
+};
+
+} // namespace database
+} // namespace libbitcoin
+
+#endif
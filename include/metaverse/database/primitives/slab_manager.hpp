@@ -53,6 +53,9 @@ public:
     /// Synchronise the payload size to disk.
     void sync() const;
 
+    /// Discard all slabs, new slabs reuse their space.
+    void clear();
+
     /// Allocate a slab and return its position, sync() after writing.
     file_offset new_slab(size_t size);
 
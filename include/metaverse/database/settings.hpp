@@ -38,6 +38,7 @@ public:
     /// Properties.
     uint32_t history_start_height;
     uint32_t stealth_start_height;
+    uint32_t write_threads;
     boost::filesystem::path directory;
     boost::filesystem::path default_directory;
 };
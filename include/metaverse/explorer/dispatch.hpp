@@ -22,6 +22,8 @@
 #define BX_DISPATCH_HPP
 
 #include <iostream>
+#include <string>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/define.hpp>
 #include <metaverse/server/server_node.hpp>
@@ -69,6 +71,20 @@ BCX_API console_result dispatch_command(int argc, const char* argv[],
     Json::Value& jv_output, 
     bc::server::server_node& node, uint8_t api_version = 1);
 
+/**
+ * Invoke the named command with json-rpc params, without a command line.
+ * @param[in]  target     The command symbolic name.
+ * @param[in]  options    Object of option names to values or value arrays.
+ * @param[in]  arguments  The positional arguments in order.
+ * @param[in]  node server_node instance.
+ * @param[in]  command version, defaults to v1.
+ * @return            The appropriate console return code { -1, 0, 1 }.
+ */
+BCX_API console_result dispatch_command(const std::string& target,
+    const Json::Value& options, const std::vector<std::string>& arguments,
+    Json::Value& jv_output,
+    bc::server::server_node& node, uint8_t api_version = 1);
+
 } // namespace explorer
 } // namespace libbitcoin
 
@@ -23,6 +23,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -46,6 +47,11 @@ public:
     virtual bool parse(std::string& out_error, std::istream& input,
         int argc, const char* argv[]);
 
+    /// Parse json-rpc params into member settings, binding each named option
+    /// and positional argument directly rather than through a command line.
+    virtual bool parse(std::string& out_error, std::istream& input,
+        const Json::Value& options, const std::vector<std::string>& arguments);
+
     virtual bool help() const;
 
     /// Load command line options (named).
@@ -64,6 +70,10 @@ protected:
     virtual void load_command_variables(variables_map& variables,
         std::istream& input, int argc, const char* argv[]);
 
+    virtual void load_json_variables(variables_map& variables,
+        std::istream& input, const Json::Value& options,
+        const std::vector<std::string>& arguments);
+
 private:
     static std::string system_config_directory();
     static boost::filesystem::path default_config_path();
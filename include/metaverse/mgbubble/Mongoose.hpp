@@ -90,10 +90,23 @@ public:
 
     const int64_t jsonrpc_id() const noexcept { return jsonrpc_id_; }
 
+    /// The method and the named options and positional arguments of the
+    /// params. No argv is built for http requests.
+    const std::string& command() const {
+        if (!command_.empty())
+            return command_;
+        throw std::logic_error{"no command found"};
+    }
+    const Json::Value& options() const noexcept { return options_; }
+    const std::vector<std::string>& arguments() const noexcept { return arguments_; }
+
     void data_to_arg(uint8_t rpc_version) override;
     
 private:
     int64_t jsonrpc_id_;
+    std::string command_;
+    Json::Value options_;
+    std::vector<std::string> arguments_;
     http_message* impl_;
 };
 
@@ -19,6 +19,7 @@
 
 #include <iostream>
 #include <functional>
+#include <string>
 #include "mongoose/mongoose.h"
 
 namespace mgbubble {
@@ -56,10 +57,14 @@ protected:
 	        }
 	        break;
 	    case MG_EV_HTTP_REPLY:
-            nc->flags |= MG_F_CLOSE_IMMEDIATELY;
+            if (!self->keep_alive())
+                nc->flags |= MG_F_CLOSE_IMMEDIATELY;
             self->reply(hm);
             self->exit();
 	        break;
+	    case MG_EV_CLOSE:
+            self->closed(nc);
+	        break;
 	    default:
 	        break;
 	  }
@@ -89,6 +94,17 @@ public:
     void exit(){ exit_ = true; }
     void reset(){ exit_ = false; }
 
+    // Keep the connection open after a reply and send the following posts
+    // on it, reconnecting if the server closed it.
+    bool keep_alive() const { return keep_alive_; }
+    void set_keep_alive(bool keep_alive){ keep_alive_ = keep_alive; }
+
+    void closed(mg_connection* nc) {
+        if (conn_ == nc)
+            conn_ = nullptr;
+        exit_ = true;
+    }
+
     void get() { 
         conn_ = mg_connect_http_opt(&mgr_, ev_handler, opts_, url_.c_str(), NULL, NULL); 
         while (!exit_){
@@ -97,7 +113,11 @@ public:
     }
     void post(std::string&& data) { post(data); }
     void post(const std::string& data) { 
-        conn_ = mg_connect_http_opt(&mgr_, ev_handler, opts_, url_.c_str(), NULL, data.c_str()); 
+        exit_ = false;
+        if (keep_alive_ && conn_ != nullptr)
+            resend(data);
+        else
+            conn_ = mg_connect_http_opt(&mgr_, ev_handler, opts_, url_.c_str(), NULL, data.c_str()); 
         while (!exit_){
             poll(milli_);
         }
@@ -112,8 +132,22 @@ public:
 
     reply_handler reply;
 private:
+    // The request line and headers mg_connect_http_opt would send, the url
+    // is "host[:port][/path]" without a scheme.
+    void resend(const std::string& data) {
+        const auto slash = url_.find('/');
+        const auto host = url_.substr(0, slash);
+        const auto path = slash == std::string::npos ? "/" : url_.substr(slash);
+
+        mg_printf(conn_, "POST %s HTTP/1.1\r\nHost: %s\r\n"
+            "Content-Length: %lu\r\n\r\n", path.c_str(), host.c_str(),
+            static_cast<unsigned long>(data.size()));
+        mg_send(conn_, data.data(), data.size());
+    }
+
     int  milli_{3000};
     bool exit_{false};
+    bool keep_alive_{false};
     mg_connect_opts opts_;
     mg_connection* conn_{nullptr};
     std::string url_;
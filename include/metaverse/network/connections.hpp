@@ -25,8 +25,10 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/channel.hpp>
@@ -63,10 +65,22 @@ public:
     void broadcast(const Message& message, channel_handler handle_channel,
         result_handler handle_complete)
     {
+        const auto channels = safe_copy();
+
+        if (channels.empty())
+        {
+            handle_complete(error::success);
+            return;
+        }
+
         // We cannot use a synchronizer here because handler closure in loop.
-        auto counter = std::make_shared<std::atomic<size_t>>(channels_.size());
+        auto counter = std::make_shared<std::atomic<size_t>>(channels.size());
 
-        for (const auto channel: safe_copy())
+        // Serialize once for each protocol version and magic in use, channels
+        // share the immutable buffer.
+        std::map<std::pair<uint32_t, uint32_t>, const_buffer> buffers;
+
+        for (const auto channel: channels)
         {
             const auto handle_send = [=](code ec)
             {
@@ -76,8 +90,15 @@ public:
                     handle_complete(error::success);
             };
 
-            // No pre-serialize, channels may have different protocol versions.
-            channel->send(message, handle_send);
+            const auto key = std::make_pair(channel->protocol_version(),
+                channel->protocol_magic());
+
+            auto buffer = buffers.find(key);
+            if (buffer == buffers.end())
+                buffer = buffers.emplace(key, const_buffer(message::serialize(
+                    key.first, message, key.second))).first;
+
+            channel->send(message.command, buffer->second, handle_send);
         }
     }
 
@@ -27,7 +27,9 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include <boost/functional/hash.hpp>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/define.hpp>
 #include <metaverse/network/settings.hpp>
@@ -38,7 +40,8 @@ namespace network {
 /// This class is thread safe.
 /// The hosts class manages a thread-safe dynamic store of network addresses.
 /// The store can be loaded and saved from/to the specified file path.
-/// The file is a line-oriented set of config::authority serializations.
+/// The file is a header and fixed size network address records, a legacy
+/// line-oriented set of config::authority serializations is also loaded.
 /// Duplicate addresses and those with zero-valued ports are disacarded.
 
 struct address_compare{
@@ -48,6 +51,23 @@ struct address_compare{
 	}
 };
 
+/// Hash and equality of the ip and port, other fields are not identity.
+struct address_hash{
+	size_t operator()(const libbitcoin::message::network_address& value) const
+	{
+		auto seed = boost::hash_range(value.ip.begin(), value.ip.end());
+		boost::hash_combine(seed, value.port);
+		return seed;
+	}
+};
+
+struct address_equal{
+	bool operator()(const libbitcoin::message::network_address& lhs, const libbitcoin::message::network_address& rhs) const
+	{
+		return lhs.ip == rhs.ip && lhs.port == rhs.port;
+	}
+};
+
 class BCT_API hosts
   : public enable_shared_from_base<hosts>
 {
@@ -80,12 +100,37 @@ public:
     virtual void store(const address::list& hosts, result_handler handler);
     address::list copy();
 private:
-    //    typedef boost::circular_buffer<address> list;
-    using list = std::set<address, address_compare >;
-
-    typedef list::iterator iterator;
-
-    iterator find(const address& host);
+    /// Addresses in a vector for uniform random selection, with a hash index
+    /// of their positions for constant time lookup and removal.
+    class list
+    {
+    public:
+        typedef address::list::const_iterator const_iterator;
+
+        /// False if the address is already present.
+        bool insert(const address& host);
+
+        /// False if the address is not present.
+        bool erase(const address& host);
+
+        bool contains(const address& host) const;
+        const address& operator[](size_t index) const;
+        size_t size() const;
+        bool empty() const;
+        void clear();
+
+        const_iterator begin() const;
+        const_iterator end() const;
+
+    private:
+        address::list hosts_;
+        std::unordered_map<address, size_t, address_hash, address_equal> index_;
+    };
+
+    bool select(address& out, const list& buffer,
+        const config::authority::list& excluded_list) const;
+    void load(std::istream& file);
+    void save(std::ostream& file, bool with_inactive) const;
     void do_store(const address& host, result_handler handler);
     void handle_timer(const code& ec);
 
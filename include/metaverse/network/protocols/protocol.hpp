@@ -124,6 +124,8 @@ protected:
 
     bool channel_stopped() { return channel_->stopped(); }
 
+    bool channel_congested() { return channel_->congested(); }
+
 private:
     threadpool& pool_;
     channel::ptr channel_;
@@ -29,6 +29,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/network/const_buffer.hpp>
 #include <metaverse/network/define.hpp>
@@ -51,7 +52,6 @@ public:
     typedef subscriber<const code&> stop_subscriber;
     typedef resubscriber<const code&, const std::string&, const_buffer,
         result_handler> send_subscriber;
-    using request_callback = std::function<void()>;
 
     /// Construct an instance.
     proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
@@ -73,6 +73,14 @@ public:
         do_send(message.command, buffer, handler);
     }
 
+    /// Send a message serialized with this proxy's protocol version and
+    /// magic, allowing one serialization to be shared among proxies.
+    void send(const std::string& command, const_buffer buffer,
+        result_handler handler)
+    {
+        do_send(command, buffer, handler);
+    }
+
     /// Subscribe to messages of the specified type on the socket.
     template <class Message>
     void subscribe(message_handler<Message>&& handler)
@@ -87,6 +95,12 @@ public:
     /// Get the authority of the far end of this socket.
     virtual const config::authority& authority() const;
 
+    /// Get the protocol version used to serialize outgoing messages.
+    virtual uint32_t protocol_version() const;
+
+    /// Get the protocol magic used to serialize outgoing messages.
+    virtual uint32_t protocol_magic() const;
+
     /// Get the p2p protocol version object of the peer.
     virtual message::version version() const;
 
@@ -111,6 +125,10 @@ public:
     virtual bool misbehaving(int32_t howmuch);
 
     virtual bool stopped() const;
+
+    /// True while the peer is not keeping up with queued sends, protocols
+    /// should hold back traffic the peer can do without.
+    virtual bool congested() const;
 protected:
     virtual void handle_activity() = 0;
     virtual void handle_stopping() = 0;
@@ -131,10 +149,20 @@ private:
     void handle_read_payload(const boost_code& ec, size_t,
         const message::heading& head);
 
+    struct pending_send
+    {
+        const_buffer buffer;
+        result_handler handler;
+    };
+
+    typedef std::vector<pending_send> send_batch;
+    typedef std::shared_ptr<send_batch> send_batch_ptr;
+
     void do_send(const std::string& command, const_buffer buffer,
         result_handler handler);
-    void handle_send(const boost_code& ec, const_buffer buffer,
-        result_handler handler);
+    void write(send_batch_ptr batch);
+    void handle_send(const boost_code& ec, send_batch_ptr batch);
+    void clear_sends(const code& ec);
 
     void handle_request(data_chunk payload_buffer, uint32_t protocol_version_, message::heading head, size_t payload_size);
 
@@ -155,8 +183,12 @@ private:
     bc::atomic<message::version::ptr> peer_version_message_;
     message_subscriber message_subscriber_;
     stop_subscriber::ptr stop_subscriber_;
-    std::queue<request_callback> outbound_queue_;
-    std::atomic_bool has_sent_;
+
+    // These are protected by send_mutex_. Bytes include the batch in flight.
+    send_batch pending_sends_;
+    size_t pending_bytes_;
+    bool sending_;
+    mutable shared_mutex send_mutex_;
 
     std::atomic_int misbehaving_;
     static boost::detail::spinlock spinlock_;
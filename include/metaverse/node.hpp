@@ -25,6 +25,8 @@
 #include <metaverse/node/protocols/protocol_block_in.hpp>
 #include <metaverse/node/protocols/protocol_block_out.hpp>
 #include <metaverse/node/protocols/protocol_block_sync.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_in.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_out.hpp>
 #include <metaverse/node/protocols/protocol_header_sync.hpp>
 #include <metaverse/node/protocols/protocol_transaction_in.hpp>
 #include <metaverse/node/protocols/protocol_transaction_out.hpp>
@@ -34,9 +36,11 @@
 #include <metaverse/node/sessions/session_inbound.hpp>
 #include <metaverse/node/sessions/session_manual.hpp>
 #include <metaverse/node/sessions/session_outbound.hpp>
+#include <metaverse/node/utility/block_pipeline.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 #include <metaverse/node/utility/performance.hpp>
 #include <metaverse/node/utility/reservation.hpp>
 #include <metaverse/node/utility/reservations.hpp>
+#include <metaverse/node/utility/short_id_hasher.hpp>
 
 #endif
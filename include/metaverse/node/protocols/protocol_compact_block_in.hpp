@@ -0,0 +1,93 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_PROTOCOL_COMPACT_BLOCK_IN_HPP
+#define MVS_NODE_PROTOCOL_COMPACT_BLOCK_IN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/network.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Receive bip152 compact blocks, reconstructing them from the transaction
+/// pool and requesting only the transactions the pool does not have.
+class BCN_API protocol_compact_block_in
+  : public network::protocol_events, track<protocol_compact_block_in>
+{
+public:
+    typedef std::shared_ptr<protocol_compact_block_in> ptr;
+
+    /// Construct a compact block protocol instance.
+    protocol_compact_block_in(network::p2p& network,
+        network::channel::ptr channel, blockchain::block_chain& blockchain,
+        blockchain::transaction_pool& pool);
+
+    ptr do_subscribe();
+
+    /// Start the protocol.
+    virtual void start();
+
+private:
+    // Local type aliases.
+    typedef message::compact_block::ptr compact_block_ptr;
+    typedef message::block_transactions::ptr block_transactions_ptr;
+    typedef message::block_message::ptr block_ptr;
+    typedef message::transaction_message::ptr transaction_ptr;
+    typedef std::vector<transaction_ptr> transaction_ptr_list;
+
+    // A block awaiting the transactions missing from our pool.
+    struct partial_block
+    {
+        chain::header header;
+        chain::transaction::list transactions;
+        std::vector<uint64_t> missing;
+    };
+
+    bool handle_receive_compact_block(const code& ec,
+        compact_block_ptr message);
+    bool handle_receive_block_transactions(const code& ec,
+        block_transactions_ptr message);
+    void handle_fetch_pool(const code& ec, const transaction_ptr_list& pool,
+        compact_block_ptr message);
+    void handle_store_block(const code& ec, block_ptr message);
+    void handle_stop(const code&);
+
+    void complete(partial_block&& block);
+    void send_get_block(const hash_digest& hash);
+
+    blockchain::block_chain& blockchain_;
+    blockchain::transaction_pool& pool_;
+    const bool compact_from_peer_;
+
+    // This is protected by mutex.
+    std::map<hash_digest, partial_block> pending_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
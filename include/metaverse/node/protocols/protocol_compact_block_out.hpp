@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_PROTOCOL_COMPACT_BLOCK_OUT_HPP
+#define MVS_NODE_PROTOCOL_COMPACT_BLOCK_OUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/network.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Serve bip152 compact blocks and the transactions missing from them,
+/// pushing new blocks unannounced to peers that ask for high bandwidth mode.
+class BCN_API protocol_compact_block_out
+  : public network::protocol_events, track<protocol_compact_block_out>
+{
+public:
+    typedef std::shared_ptr<protocol_compact_block_out> ptr;
+
+    /// Construct a compact block protocol instance.
+    protocol_compact_block_out(network::p2p& network,
+        network::channel::ptr channel, blockchain::block_chain& blockchain);
+
+    ptr do_subscribe();
+
+    /// Start the protocol.
+    virtual void start();
+
+private:
+    // Local type aliases.
+    typedef message::send_compact_blocks::ptr send_compact_blocks_ptr;
+    typedef message::get_block_transactions::ptr get_block_transactions_ptr;
+    typedef message::get_data::ptr get_data_ptr;
+    typedef message::block_message::ptr_list block_ptr_list;
+
+    static message::compact_block to_compact(const chain::block& block);
+
+    void send_compact_block(const code& ec, chain::block::ptr block,
+        const hash_digest& hash);
+    void send_block_transactions(const code& ec, chain::block::ptr block,
+        get_block_transactions_ptr message);
+
+    bool handle_receive_send_compact_blocks(const code& ec,
+        send_compact_blocks_ptr message);
+    bool handle_receive_get_data(const code& ec, get_data_ptr message);
+    bool handle_receive_get_block_transactions(const code& ec,
+        get_block_transactions_ptr message);
+    bool handle_reorganized(const code& ec, size_t fork_point,
+        const block_ptr_list& incoming, const block_ptr_list& outgoing);
+    void handle_stop(const code&);
+
+    blockchain::block_chain& blockchain_;
+    const bool compact_to_peer_;
+    std::atomic<bool> high_bandwidth_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
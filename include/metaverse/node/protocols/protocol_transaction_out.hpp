@@ -22,8 +22,10 @@
 #define MVS_NODE_PROTOCOL_TRANSACTION_OUT_HPP
 
 #include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/network.hpp>
 #include <metaverse/node/define.hpp>
@@ -50,17 +52,25 @@ public:
 private:
     // Local type aliases.
     typedef message::transaction_message::ptr transaction_ptr;
+    typedef std::vector<transaction_ptr> transaction_ptr_list;
+    typedef std::shared_ptr<hash_list> hash_list_ptr;
     typedef message::fee_filter::ptr fee_filter_ptr;
     typedef message::memory_pool::ptr memory_pool_ptr;
     typedef message::get_data::ptr get_data_ptr;
     typedef chain::point::indexes index_list;
 
+    static uint64_t fee_rate(const message::transaction_message& tx);
+
     void send_transaction(const code& ec,
         const chain::transaction& transaction, const hash_digest& hash);
+    void send_memory_pool(const code& ec, hash_list_ptr hashes,
+        size_t offset);
 
     bool handle_receive_get_data(const code& ec, get_data_ptr message);
     bool handle_receive_fee_filter(const code& ec, fee_filter_ptr message);
     bool handle_receive_memory_pool(const code& ec, memory_pool_ptr message);
+    void handle_fetch_memory_pool(const code& ec,
+        const transaction_ptr_list& transactions);
 
     void handle_stop(const code&);
     bool handle_floated(const code& ec, const index_list& unconfirmed,
@@ -70,6 +80,7 @@ private:
     blockchain::transaction_pool& pool_;
     std::atomic<uint64_t> minimum_fee_;
     const bool relay_to_peer_;
+    const bool fee_filter_from_peer_;
 };
 
 } // namespace node
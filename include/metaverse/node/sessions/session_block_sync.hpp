@@ -59,6 +59,7 @@ protected:
 
 private:
     void handle_started(const code& ec, result_handler handler);
+    void handle_synchronized(const code& ec, result_handler handler);
     void new_connection(network::connector::ptr connect,
         reservation::ptr row, result_handler handler);
     void handle_complete(const code& ec, network::channel::ptr channel, network::connector::ptr connect,
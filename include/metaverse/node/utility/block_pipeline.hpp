@@ -0,0 +1,97 @@
+/**
+ * Copyright (c) 2011-2016 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_BLOCK_PIPELINE_HPP
+#define MVS_NODE_BLOCK_PIPELINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Staging between block download and import during sync, thread safe.
+/// Blocks arrive from many channels out of order. Each is hashed on the
+/// threadpool, then held in a bounded window and imported in height order
+/// by one committer, so download, hashing and import overlap.
+class BCN_API block_pipeline
+  : public enable_shared_from_base<block_pipeline>
+{
+public:
+    typedef std::shared_ptr<block_pipeline> ptr;
+    typedef std::function<void()> completion_handler;
+    typedef handle0 result_handler;
+
+    /// Construct a pipeline expecting the given height first, holding at
+    /// most window blocks.
+    block_pipeline(threadpool& pool, blockchain::simple_chain& chain,
+        size_t first_height, size_t window);
+
+    /// This class is not copyable.
+    block_pipeline(const block_pipeline&) = delete;
+    void operator=(const block_pipeline&) = delete;
+
+    /// Stage the block for import, importing directly if the window is full.
+    /// The handler is called once the block is imported, or with
+    /// merkle_mismatch if it is dropped for a merkle root that does not
+    /// match its header.
+    bool import(chain::block::ptr block, size_t height,
+        result_handler handler);
+
+    /// Import all staged blocks, including those being hashed, then call the
+    /// handler. Blocks staged after this are imported without waiting.
+    void flush(completion_handler handler);
+
+private:
+    struct staged_block
+    {
+        chain::block::ptr block;
+        result_handler handler;
+    };
+
+    typedef std::map<size_t, staged_block> block_map;
+
+    void prepare(chain::block::ptr block, size_t height,
+        result_handler handler);
+    void commit();
+
+    // Thread safe.
+    blockchain::simple_chain& chain_;
+    dispatcher dispatch_;
+    const size_t window_;
+
+    // Protected by mutex.
+    block_map staged_;
+    size_t preparing_;
+    size_t next_height_;
+    bool committing_;
+    bool flushing_;
+    completion_handler flushed_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -92,9 +92,16 @@ public:
     /// Add to the blockchain, with height determined by the reservation.
     void import(chain::block::ptr block);
 
+    /// Add the hash of a block rejected on any row, false if stopped.
+    bool restore(const hash_digest& hash, size_t height);
+
     /// Determine if the reservation was partitioned and reset partition flag.
     bool toggle_partitioned();
 
+    /// Determine if the peer sent a block that was rejected after import and
+    /// reset the rejected flag. The block hash is handed to a live row.
+    bool toggle_rejected();
+
     /// Move half of the reservation to the specified reservation.
     bool partition(reservation::ptr minimal);
 
@@ -135,6 +142,11 @@ private:
     // Get the height of the block hash, remove and return true if it is found.
     bool find_height_and_erase(const hash_digest& hash, uint32_t& out_height);
 
+    // Log the completed import or hand back the hash of a rejected block.
+    void handle_import(const code& ec, const hash_digest& hash,
+        uint32_t height);
+    void reject(const hash_digest& hash, uint32_t height);
+
     // Update rate history to reflect an additional block of the given size.
     void update_rate(size_t events, const std::chrono::microseconds& database);
 
@@ -156,6 +168,7 @@ private:
     // Protected by hash mutex.
     bool pending_;
     bool partitioned_;
+    bool rejected_;
     hash_heights heights_;
     mutable upgrade_mutex hash_mutex_;
 
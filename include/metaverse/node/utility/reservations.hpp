@@ -23,11 +23,13 @@
 #include <atomic>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 #include <vector>
 #include <metaverse/blockchain.hpp>
 #include <metaverse/node/define.hpp>
 #include <metaverse/node/settings.hpp>
+#include <metaverse/node/utility/block_pipeline.hpp>
 #include <metaverse/node/utility/header_queue.hpp>
 #include <metaverse/node/utility/reservation.hpp>
 
@@ -46,11 +48,12 @@ public:
     } rate_statistics;
 
     typedef std::shared_ptr<reservations> ptr;
+    typedef std::function<void()> completion_handler;
 
     /// Construct a reservation table of reservations, allocating hashes evenly
     /// among the rows up to the limit of a single get headers p2p request.
-    reservations(header_queue& hashes, blockchain::simple_chain& chain,
-        const settings& settings);
+    reservations(threadpool& pool, header_queue& hashes,
+        blockchain::simple_chain& chain, const settings& settings);
 
     /// The average and standard deviation of block import rates.
     rate_statistics rates() const;
@@ -59,7 +62,20 @@ public:
     reservation::list table() const;
 
     /// Import the given block to the blockchain at the specified height.
-    bool import(chain::block::ptr block, size_t height);
+    /// The import may complete after return, see flush. The handler is
+    /// called once it completes or the block is rejected.
+    bool import(chain::block::ptr block, size_t height,
+        block_pipeline::result_handler handler);
+
+    /// Complete all imports, then call the handler.
+    void flush(completion_handler handler);
+
+    /// Hand the hash of a rejected block to a live row for request again,
+    /// false if every row has stopped.
+    bool restore(const hash_digest& hash, size_t height);
+
+    /// True if a rejected block could not be restored, leaving a gap.
+    bool incomplete() const;
 
     /// Populate a starved row by taking half of the hashes from a weak row.
     bool populate(reservation::ptr minimal);
@@ -98,6 +114,7 @@ private:
     // Thread safe.
     header_queue& hashes_;
     blockchain::simple_chain& blockchain_;
+    block_pipeline::ptr pipeline_;
 
     // Protected by mutex.
     reservation::list table_;
@@ -105,6 +122,7 @@ private:
 
     const uint32_t timeout_;
     std::atomic<size_t> max_request_;
+    std::atomic<bool> incomplete_;
 };
 
 } // namespace node
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_NODE_SHORT_ID_HASHER_HPP
+#define MVS_NODE_SHORT_ID_HASHER_HPP
+
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Compute bip152 short transaction ids for a compact block. The siphash
+/// keys are taken from sha256(header + nonce) so that ids differ per block
+/// and per sender, which keeps collisions from being engineered.
+class BCN_API short_id_hasher
+{
+public:
+    /// Derive the keys from the header and nonce of a compact block.
+    short_id_hasher(const chain::header& header, uint64_t nonce);
+
+    /// The 48 bit short id of a transaction hash.
+    uint64_t operator()(const hash_digest& tx_hash) const;
+
+    /// Convert between the numeric and the wire (little endian) forms.
+    static uint64_t to_number(const mini_hash& id);
+    static mini_hash to_mini_hash(uint64_t id);
+
+private:
+    uint64_t k0_;
+    uint64_t k1_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
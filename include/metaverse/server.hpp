@@ -31,6 +31,7 @@
 #include <metaverse/server/services/block_service.hpp>
 #include <metaverse/server/services/heartbeat_service.hpp>
 #include <metaverse/server/services/query_service.hpp>
+#include <metaverse/server/services/stratum_service.hpp>
 #include <metaverse/server/services/transaction_service.hpp>
 #include <metaverse/server/utility/address_key.hpp>
 #include <metaverse/server/utility/authenticator.hpp>
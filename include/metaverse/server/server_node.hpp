@@ -33,6 +33,7 @@
 #include <metaverse/server/services/block_service.hpp>
 #include <metaverse/server/services/heartbeat_service.hpp>
 #include <metaverse/server/services/query_service.hpp>
+#include <metaverse/server/services/stratum_service.hpp>
 #include <metaverse/server/services/transaction_service.hpp>
 #include <metaverse/server/utility/authenticator.hpp>
 #include <metaverse/server/workers/notification_worker.hpp>
@@ -116,6 +117,7 @@ private:
     bool start_heartbeat_services();
     bool start_block_services();
     bool start_transaction_services();
+    bool start_stratum_service();
     bool start_query_workers(bool secure);
     
     bool open_ui();
@@ -140,6 +142,7 @@ private:
     transaction_service public_transaction_service_;
     notification_worker secure_notification_worker_;
     notification_worker public_notification_worker_;
+    stratum_service stratum_service_;
 };
 
 } // namespace server
@@ -0,0 +1,158 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_STRATUM_SERVICE_HPP
+#define MVS_SERVER_STRATUM_SERVICE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+#include <jsoncpp/json/json.h>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+#include <metaverse/server/settings.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+class server_node;
+
+// This class is thread safe.
+// Push mining jobs to connected miners over line delimited json-rpc
+// (the eth_submitLogin/eth_getWork/eth_submitWork stratum dialect),
+// running on the node threadpool.
+class BCS_API stratum_service
+{
+public:
+    typedef std::shared_ptr<stratum_service> ptr;
+
+    /// Share and hashrate statistics of one logged in worker.
+    struct worker_statistics
+    {
+        std::string name;
+        std::string authority;
+        uint64_t accepted_shares;
+        uint64_t rejected_shares;
+        uint64_t stale_shares;
+        uint64_t blocks_found;
+        uint64_t reported_hashrate;
+
+        /// Accepted shares times share difficulty over connected seconds.
+        uint64_t estimated_hashrate;
+    };
+
+    /// Construct a stratum service.
+    stratum_service(server_node& node);
+
+    /// This class is not copyable.
+    stratum_service(const stratum_service&) = delete;
+    void operator=(const stratum_service&) = delete;
+
+    /// Start the service.
+    bool start();
+
+    /// Stop the service.
+    bool stop();
+
+    /// Statistics of all connected workers.
+    std::vector<worker_statistics> workers() const;
+
+private:
+    struct session;
+    typedef std::shared_ptr<session> session_ptr;
+    typedef bc::message::block_message::ptr_list block_list;
+    typedef chain::point::indexes index_list;
+    typedef bc::message::transaction_message::ptr transaction_ptr;
+
+    // A submitted share waiting for batch verification.
+    struct share
+    {
+        session_ptr owner;
+        Json::Value id;
+        chain::header header;
+        std::string nonce;
+        std::string mix_hash;
+        std::string header_hash;
+    };
+
+    // The job currently pushed to workers.
+    struct job
+    {
+        std::string header_hash;
+        std::string seed_hash;
+        std::string share_boundary;
+        chain::header header;
+    };
+
+    void accept();
+    void handle_accept(const boost::system::error_code& ec, session_ptr session);
+    void read(session_ptr session);
+    void handle_read(const boost::system::error_code& ec, size_t size,
+        session_ptr session);
+    void handle_request(session_ptr session, const std::string& line);
+    void send(session_ptr session, const Json::Value& message);
+    void write(session_ptr session);
+    void handle_write(const boost::system::error_code& ec,
+        session_ptr session);
+    void close(session_ptr session);
+
+    void handle_login(session_ptr session, const Json::Value& request);
+    void handle_get_work(session_ptr session, const Json::Value& request);
+    void handle_submit_work(session_ptr session, const Json::Value& request);
+    void handle_submit_hashrate(session_ptr session, const Json::Value& request);
+
+    bool handle_reorganization(const code& ec, uint64_t fork_point,
+        const block_list& new_blocks, const block_list&);
+    bool handle_pool_transaction(const code& ec, const index_list&,
+        transaction_ptr);
+    void handle_template_timer(const code& ec);
+    bool refresh_job(bool rebuild = false);
+    void push_job();
+    Json::Value job_result() const;
+    void verify_shares();
+
+    const server::settings& settings_;
+    std::atomic<bool> stopped_;
+
+    // These are thread safe.
+    server_node& node_;
+    asio::acceptor acceptor_;
+
+    mutable std::mutex sessions_mutex_;
+    std::set<session_ptr> sessions_;
+
+    mutable std::mutex job_mutex_;
+    job job_;
+
+    deadline::ptr template_timer_;
+    std::atomic<bool> template_refresh_pending_;
+
+    std::mutex shares_mutex_;
+    std::vector<share> shares_;
+    bool verifying_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
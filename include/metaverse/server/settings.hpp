@@ -46,6 +46,8 @@ public:
     uint32_t subscription_limit;
     std::string mongoose_listen;
     std::string websocket_listen;
+    std::string stratum_listen;
+    uint64_t stratum_share_difficulty;
     std::string log_level;
     bool administrator_required;
     bool secure_only;
@@ -55,6 +57,7 @@ public:
     bool block_service_enabled;
     bool transaction_service_enabled;
     bool websocket_service_enabled;
+    bool stratum_service_enabled;
 
     config::endpoint public_query_endpoint;
     config::endpoint public_heartbeat_endpoint;
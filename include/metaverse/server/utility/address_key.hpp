@@ -39,8 +39,9 @@ public:
     const binary& prefix_filter() const;
 
 private:
-    const route& reply_to_;
-    const binary& prefix_filter_;
+    // Held by value, keys outlive the subscribe call that creates them.
+    route reply_to_;
+    binary prefix_filter_;
 };
 
 } // namespace server
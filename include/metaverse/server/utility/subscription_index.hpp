@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SERVER_SUBSCRIPTION_INDEX_HPP
+#define MVS_SERVER_SUBSCRIPTION_INDEX_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/define.hpp>
+#include <metaverse/server/messages/route.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+/// This class is thread safe.
+/// Subscriptions indexed by the bits of their prefix filter in a binary trie,
+/// so a field is matched against only the filters along its own path.
+class BCS_API subscription_index
+{
+public:
+    typedef std::shared_ptr<uint8_t> sequence_ptr;
+
+    struct subscription
+    {
+        route reply_to;
+        uint32_t id;
+        binary prefix_filter;
+
+        /// Null unless the subscriber detects dropped messages.
+        sequence_ptr sequence;
+    };
+
+    typedef std::vector<subscription> list;
+
+    subscription_index();
+
+    /// Add a subscription, false if the route already has this filter.
+    bool insert(const route& reply_to, uint32_t id,
+        const binary& prefix_filter, sequence_ptr sequence=nullptr);
+
+    /// Remove the subscription of the route to this filter, if any.
+    bool remove(const route& reply_to, const binary& prefix_filter);
+
+    /// The subscriptions with a filter that is a prefix of the field.
+    list find(const binary& field) const;
+
+private:
+    struct node
+    {
+        std::unique_ptr<node> children[2];
+        list subscriptions;
+    };
+
+    node root_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace server
+} // namespace libbitcoin
+
+#endif
@@ -23,12 +23,14 @@
 
 #include <cstdint>
 #include <memory>
+#include <string>
 #include <metaverse/bitcoin.hpp>
 #include <metaverse/server/define.hpp>
 #include <metaverse/server/messages/message.hpp>
 #include <metaverse/server/messages/route.hpp>
 #include <metaverse/server/settings.hpp>
 #include <metaverse/server/utility/address_key.hpp>
+#include <metaverse/server/utility/subscription_index.hpp>
 
 namespace libbitcoin {
 namespace server {
@@ -72,16 +74,12 @@ protected:
 
 private:
     typedef chain::point::indexes index_list;
-    typedef std::shared_ptr<uint8_t> sequence_ptr;
+    typedef subscription_index::sequence_ptr sequence_ptr;
+    typedef subscription_index::list subscription_list;
     typedef bc::message::block_message::ptr_list block_list;
 
-    typedef notifier<address_key, const code&,
-        const wallet::payment_address&, int32_t, const hash_digest&,
-        const chain::transaction&> payment_subscriber;
-    typedef notifier<address_key, const code&, uint32_t, uint32_t,
-        const hash_digest&, const chain::transaction&> stealth_subscriber;
-    typedef notifier<address_key, const code&, const binary&, uint32_t,
-        const hash_digest&, const chain::transaction&> address_subscriber;
+    // Notifiers keep the subscription lifetimes, the indexes route events.
+    typedef notifier<address_key, const code&> subscription_notifier;
     typedef notifier<address_key, const code&, uint32_t,
         const hash_digest&, const hash_digest&> penetration_subscriber;
 
@@ -102,43 +100,38 @@ private:
     void notify_transaction(uint32_t height, const hash_digest& block_hash,
         const chain::transaction& tx);
 
+    // The transaction is serialized into tx_data on the first match.
     // v2/v3 (deprecated)
     void notify_payment(const wallet::payment_address& address,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
-    void notify_stealth(uint32_t prefix, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
+        const binary& field, uint32_t height, const hash_digest& block_hash,
+        const chain::transaction& tx, data_chunk& tx_data);
+    void notify_stealth(uint32_t prefix, const binary& field, uint32_t height,
+        const hash_digest& block_hash, const chain::transaction& tx,
+        data_chunk& tx_data);
 
     // v3
     void notify_address(const binary& field, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
+        const hash_digest& block_hash, const chain::transaction& tx,
+        data_chunk& tx_data);
     void notify_penetration(uint32_t height, const hash_digest& block_hash,
         const hash_digest& tx_hash);
 
     // Send a notification to the subscriber.
     void send(const route& reply_to, const std::string& command,
         uint32_t id, const data_chunk& payload);
-    void send_payment(const route& reply_to, uint32_t id,
+    void send_payment(const subscription_list& subscribers,
         const wallet::payment_address& address, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx);
-    void send_stealth(const route& reply_to, uint32_t id, uint32_t prefix,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
-    void send_address(const route& reply_to, uint32_t id, uint8_t sequence,
+        const hash_digest& block_hash, const data_chunk& tx_data);
+    void send_stealth(const subscription_list& subscribers, uint32_t prefix,
         uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx);
+        const data_chunk& tx_data);
+    void send_address(const subscription_list& subscribers, uint32_t height,
+        const hash_digest& block_hash, const data_chunk& tx_data);
 
-    bool handle_payment(const code& ec, const wallet::payment_address& address,
-        uint32_t height, const hash_digest& block_hash,
-        const chain::transaction& tx, const route& reply_to, uint32_t id,
+    // Invoked only to end a subscription, with the reason.
+    bool handle_subscription(const code& ec, subscription_index& index,
+        const std::string& command, const route& reply_to, uint32_t id,
         const binary& prefix_filter);
-    bool handle_stealth(const code& ec, uint32_t prefix, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx,
-        const route& reply_to, uint32_t id, const binary& prefix_filter);
-    bool handle_address(const code& ec, const binary& field, uint32_t height,
-        const hash_digest& block_hash, const chain::transaction& tx,
-        const route& reply_to, uint32_t id, const binary& prefix_filter,
-        sequence_ptr sequence);
 
     const bool secure_;
     const server::settings& settings_;
@@ -146,10 +139,16 @@ private:
     // These are thread safe.
     server_node& node_;
     bc::protocol::zmq::authenticator& authenticator_;
-    address_subscriber::ptr address_subscriber_;
-    payment_subscriber::ptr payment_subscriber_;
-    stealth_subscriber::ptr stealth_subscriber_;
+    subscription_notifier::ptr address_subscriber_;
+    subscription_notifier::ptr payment_subscriber_;
+    subscription_notifier::ptr stealth_subscriber_;
     penetration_subscriber::ptr penetration_subscriber_;
+    subscription_index address_index_;
+    subscription_index payment_index_;
+    subscription_index stealth_index_;
+
+    // Sends are ordered, which also orders the address sequences.
+    dispatcher dispatch_;
 };
 
 } // namespace server
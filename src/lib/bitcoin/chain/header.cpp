@@ -82,8 +82,7 @@ header::header(uint32_t version, const hash_digest& previous_block_hash,
     nonce(nonce),
     mixhash(mixhash),
     number(number),
-    transaction_count(transaction_count),
-    hash_(nullptr)
+    transaction_count(transaction_count)
 {
 }
 
@@ -105,8 +104,7 @@ header::header(uint32_t version, hash_digest&& previous_block_hash,
     nonce(nonce),
     mixhash(mixhash),
     number(number),
-    transaction_count(transaction_count),
-    hash_(nullptr)
+    transaction_count(transaction_count)
 {
 }
 
@@ -121,6 +119,7 @@ header& header::operator=(header&& other)
     mixhash = other.mixhash;
     number = other.number;
     transaction_count = other.transaction_count;
+    hash_.reset();
     return *this;
 }
 
@@ -136,6 +135,7 @@ header& header::operator=(const header& other)
     mixhash = other.mixhash;
     number = other.number;
     transaction_count = other.transaction_count;
+    hash_.reset();
     return *this;
 }
 
@@ -157,10 +157,7 @@ void header::reset()
     timestamp = 0;
     bits = 0;
     nonce = 0;
-
-    mutex_.lock();
     hash_.reset();
-    mutex_.unlock();
 }
 
 bool header::from_data(const data_chunk& data,
@@ -255,23 +252,13 @@ uint64_t header::serialized_size(bool with_transaction_count) const
 
 hash_digest header::hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!hash_)
+    hash_digest hash;
+    if (!hash_.get(hash))
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        hash_.reset(new hash_digest(bitcoin_hash(to_data(false))));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
+        hash = bitcoin_hash(to_data(false));
+        hash_.set(hash);
     }
 
-    hash_digest hash = *hash_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
     return hash;
 }
 
@@ -34,6 +34,7 @@
 #include <metaverse/bitcoin/math/script_number.hpp>
 #include <metaverse/bitcoin/utility/container_sink.hpp>
 #include <metaverse/bitcoin/utility/container_source.hpp>
+#include <metaverse/bitcoin/utility/endian.hpp>
 #include <metaverse/bitcoin/utility/istream_reader.hpp>
 #include <metaverse/bitcoin/utility/ostream_writer.hpp>
 #include <metaverse/bitcoin/utility/string.hpp>
@@ -49,6 +50,9 @@ static const data_chunk stack_false_value;
 static const data_chunk stack_true_value{ 1 };
 static constexpr uint64_t op_counter_limit = 201;
 
+// The largest parse buffer kept between scripts.
+static constexpr size_t max_retained_script = 1024 * 1024;
+
 enum class signature_parse_result
 {
     valid,
@@ -170,8 +174,11 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
 {
     reset();
 
+    // The serialized script is only needed while it is parsed, so a buffer
+    // per thread is reused rather than allocating one for every script.
+    static thread_local data_chunk raw_script;
+
     auto result = true;
-    data_chunk raw_script;
 
     if (prefix)
     {
@@ -182,8 +189,10 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
         if (result)
         {
             auto script_length32 = static_cast<uint32_t>(script_length);
-            raw_script = source.read_data(script_length32);
-            result = source && (raw_script.size() == script_length32);
+            raw_script.resize(script_length32);
+            const auto read = source.read_data(raw_script.data(),
+                script_length32);
+            result = source && (read == script_length32);
         }
     }
     else
@@ -195,6 +204,10 @@ bool script::from_data(reader& source, bool prefix, parse_mode mode)
     if (result)
         result = deserialize(raw_script, mode);
 
+    // Do not hold on to the buffer of an unusually large script.
+    if (raw_script.capacity() > max_retained_script)
+        data_chunk().swap(raw_script);
+
     if (!result)
         reset();
 
@@ -346,12 +359,65 @@ bool script::deserialize(const data_chunk& raw_script, parse_mode mode)
     return result;
 }
 
+// The number of operations in a serialized script, used to reserve before
+// parsing. A malformed script is counted up to the malformed operation.
+static size_t count_operations(const data_chunk& raw_script)
+{
+    size_t count = 0;
+    auto it = raw_script.begin();
+
+    while (it != raw_script.end())
+    {
+        ++count;
+        const auto code = *it++;
+        const auto remaining = static_cast<size_t>(raw_script.end() - it);
+        size_t size = 0;
+
+        if (code > 0 && code < static_cast<uint8_t>(opcode::pushdata1))
+        {
+            size = code;
+        }
+        else if (code == static_cast<uint8_t>(opcode::pushdata1))
+        {
+            if (remaining < 1)
+                break;
+
+            size = it[0];
+            it += 1;
+        }
+        else if (code == static_cast<uint8_t>(opcode::pushdata2))
+        {
+            if (remaining < 2)
+                break;
+
+            size = from_little_endian_unsafe<uint16_t>(it);
+            it += 2;
+        }
+        else if (code == static_cast<uint8_t>(opcode::pushdata4))
+        {
+            if (remaining < 4)
+                break;
+
+            size = from_little_endian_unsafe<uint32_t>(it);
+            it += 4;
+        }
+
+        if (size > static_cast<size_t>(raw_script.end() - it))
+            break;
+
+        it += size;
+    }
+
+    return count;
+}
+
 bool script::parse(const data_chunk& raw_script)
 {
     auto result = true;
 
     if (raw_script.begin() != raw_script.end())
     {
+        operations.reserve(count_operations(raw_script));
         data_source istream(raw_script);
 
         while (result && istream &&
@@ -59,7 +59,7 @@ transaction transaction::factory_from_data(reader& source)
 // default constructors
 
 transaction::transaction()
-  : version(0), locktime(0), hash_(nullptr)
+  : version(0), locktime(0)
 {
 }
 
@@ -73,8 +73,7 @@ transaction::transaction(uint32_t version, uint32_t locktime,
   : version(version),
     locktime(locktime),
     inputs(inputs),
-    outputs(outputs),
-    hash_(nullptr)
+    outputs(outputs)
 {
 }
 
@@ -90,8 +89,7 @@ transaction::transaction(uint32_t version, uint32_t locktime,
   : version(version),
     locktime(locktime),
     inputs(std::forward<input::list>(inputs)),
-    outputs(std::forward<output::list>(outputs)),
-    hash_(nullptr)
+    outputs(std::forward<output::list>(outputs))
 {
 }
 
@@ -101,6 +99,7 @@ transaction& transaction::operator=(transaction&& other)
     locktime = other.locktime;
     inputs = std::move(other.inputs);
     outputs = std::move(other.outputs);
+    hash_.reset();
     return *this;
 }
 
@@ -111,6 +110,7 @@ transaction& transaction::operator=(const transaction& other)
     locktime = other.locktime;
     inputs = other.inputs;
     outputs = other.outputs;
+    hash_.reset();
     return *this;
 }
 
@@ -128,10 +128,7 @@ void transaction::reset()
     inputs.shrink_to_fit();
     outputs.clear();
     outputs.shrink_to_fit();
-
-    mutex_.lock();
     hash_.reset();
-    mutex_.unlock();
 }
 
 bool transaction::from_data(const data_chunk& data)
@@ -270,23 +267,13 @@ std::string transaction::to_string(uint32_t flags) const
 
 hash_digest transaction::hash() const
 {
-    ///////////////////////////////////////////////////////////////////////////
-    // Critical Section
-    mutex_.lock_upgrade();
-
-    if (!hash_)
+    hash_digest hash;
+    if (!hash_.get(hash))
     {
-        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        mutex_.unlock_upgrade_and_lock();
-        hash_.reset(new hash_digest(bitcoin_hash(to_data())));
-        mutex_.unlock_and_lock_upgrade();
-        //---------------------------------------------------------------------
+        hash = bitcoin_hash(to_data());
+        hash_.set(hash);
     }
 
-    hash_digest hash = *hash_;
-    mutex_.unlock_upgrade();
-    ///////////////////////////////////////////////////////////////////////////
-
     return hash;
 }
 
@@ -34,6 +34,7 @@
 #include "external/sha1.h"
 #include "external/sha256.h"
 #include "external/sha512.h"
+#include "sha256_engine.hpp"
 
 namespace libbitcoin {
 
@@ -107,7 +108,16 @@ long_hash pkcs5_pbkdf2_hmac_sha512(data_slice passphrase,
 
 hash_digest bitcoin_hash(data_slice data)
 {
-    return sha256_hash(sha256_hash(data));
+    hash_digest hash;
+    sha256::double_hash(hash.data(), data.data(), data.size());
+    return hash;
+}
+
+void bitcoin_hash_pairs(hash_digest* out, const hash_digest* in,
+    size_t pairs)
+{
+    static_assert(sizeof(hash_digest) == hash_size, "unexpected padding");
+    sha256::double_hash_64(out->data(), in->data(), pairs);
 }
 
 short_hash bitcoin_short_hash(data_slice data)
@@ -115,6 +125,61 @@ short_hash bitcoin_short_hash(data_slice data)
     return ripemd160_hash(sha256_hash(data));
 }
 
+static inline uint64_t rotate_left(uint64_t value, int bits)
+{
+    return (value << bits) | (value >> (64 - bits));
+}
+
+static inline void sip_round(uint64_t& v0, uint64_t& v1, uint64_t& v2,
+    uint64_t& v3)
+{
+    v0 += v1; v1 = rotate_left(v1, 13); v1 ^= v0; v0 = rotate_left(v0, 32);
+    v2 += v3; v3 = rotate_left(v3, 16); v3 ^= v2;
+    v0 += v3; v3 = rotate_left(v3, 21); v3 ^= v0;
+    v2 += v1; v1 = rotate_left(v1, 17); v1 ^= v2; v2 = rotate_left(v2, 32);
+}
+
+uint64_t siphash24(uint64_t k0, uint64_t k1, data_slice data)
+{
+    uint64_t v0 = 0x736f6d6570736575ull ^ k0;
+    uint64_t v1 = 0x646f72616e646f6dull ^ k1;
+    uint64_t v2 = 0x6c7967656e657261ull ^ k0;
+    uint64_t v3 = 0x7465646279746573ull ^ k1;
+
+    const auto size = data.size();
+    const auto bytes = data.data();
+    const auto whole = size - (size % 8);
+
+    for (size_t offset = 0; offset < whole; offset += 8)
+    {
+        uint64_t word = 0;
+        for (size_t byte = 0; byte < 8; ++byte)
+            word |= uint64_t(bytes[offset + byte]) << (8 * byte);
+
+        v3 ^= word;
+        sip_round(v0, v1, v2, v3);
+        sip_round(v0, v1, v2, v3);
+        v0 ^= word;
+    }
+
+    // The final word holds the remaining bytes and the length in its top byte.
+    uint64_t last = uint64_t(size & 0xff) << 56;
+    for (size_t byte = 0; byte < size - whole; ++byte)
+        last |= uint64_t(bytes[whole + byte]) << (8 * byte);
+
+    v3 ^= last;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    v0 ^= last;
+
+    v2 ^= 0xff;
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    sip_round(v0, v1, v2, v3);
+    return v0 ^ v1 ^ v2 ^ v3;
+}
+
 static void handle_script_result(int result)
 {
     if (result == 0)
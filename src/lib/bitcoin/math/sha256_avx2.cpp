@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_engine.hpp"
+
+#ifdef WITH_SHA256_AVX2
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "sha256_lanes.hpp"
+
+namespace libbitcoin {
+namespace sha256 {
+namespace {
+
+// Eight lanes of 32 bit words in AVX registers, compiled with -mavx2.
+struct avx2_vector
+{
+    typedef __m256i word;
+
+    static word set(uint32_t value)
+    {
+        return _mm256_set1_epi32(value);
+    }
+
+    static word add(word left, word right)
+    {
+        return _mm256_add_epi32(left, right);
+    }
+
+    static word bit_and(word left, word right)
+    {
+        return _mm256_and_si256(left, right);
+    }
+
+    static word bit_or(word left, word right)
+    {
+        return _mm256_or_si256(left, right);
+    }
+
+    static word bit_xor(word left, word right)
+    {
+        return _mm256_xor_si256(left, right);
+    }
+
+    template <int Bits>
+    static word shift_right(word value)
+    {
+        return _mm256_srli_epi32(value, Bits);
+    }
+
+    template <int Bits>
+    static word shift_left(word value)
+    {
+        return _mm256_slli_epi32(value, Bits);
+    }
+
+    static word load(const uint8_t* in, size_t offset)
+    {
+        return _mm256_set_epi32(
+            read_big_endian(in + 7 * block_size + offset),
+            read_big_endian(in + 6 * block_size + offset),
+            read_big_endian(in + 5 * block_size + offset),
+            read_big_endian(in + 4 * block_size + offset),
+            read_big_endian(in + 3 * block_size + offset),
+            read_big_endian(in + 2 * block_size + offset),
+            read_big_endian(in + 1 * block_size + offset),
+            read_big_endian(in + 0 * block_size + offset));
+    }
+
+    static void store(uint8_t* out, size_t offset, word value)
+    {
+        uint32_t words[avx2_lanes];
+        _mm256_storeu_si256(reinterpret_cast<word*>(words), value);
+
+        for (size_t lane = 0; lane < avx2_lanes; ++lane)
+            write_big_endian(out + lane * digest_size + offset, words[lane]);
+    }
+};
+
+} // namespace
+
+void double_hash_64_avx2(uint8_t* out, const uint8_t* in)
+{
+    lanes<avx2_vector>::double_hash_64(out, in);
+}
+
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,335 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_engine.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "external/sha256.h"
+
+#if defined(WITH_SHA256_SSE41) || defined(WITH_SHA256_AVX2) || \
+    defined(WITH_SHA256_SHANI)
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+namespace libbitcoin {
+namespace sha256 {
+
+static const uint32_t initial_state[state_size]
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+// Padding of a 64 byte message, a 512 bit length.
+static const uint8_t padding_64[block_size]
+{
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x02, 0x00
+};
+
+// Padding of a 32 byte message, a 256 bit length.
+static const uint8_t padding_32[block_size - digest_size]
+{
+    0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x01, 0x00
+};
+
+static void transform_portable(uint32_t* state, const uint8_t* blocks,
+    size_t count)
+{
+    for (; count > 0; --count, blocks += block_size)
+        SHA256Transform(state, blocks);
+}
+
+static void write_state(uint8_t* out, const uint32_t* state)
+{
+    for (size_t index = 0; index < state_size; ++index, out += 4)
+    {
+        out[0] = uint8_t(state[index] >> 24);
+        out[1] = uint8_t(state[index] >> 16);
+        out[2] = uint8_t(state[index] >> 8);
+        out[3] = uint8_t(state[index]);
+    }
+}
+
+// Second hash of a digest held in the state, a single block.
+static void hash_digest_state(uint8_t* out, uint32_t* state,
+    transform_function transform)
+{
+    uint8_t block[block_size];
+    write_state(block, state);
+    std::memcpy(block + digest_size, padding_32, sizeof(padding_32));
+
+    std::memcpy(state, initial_state, sizeof(initial_state));
+    transform(state, block, 1);
+    write_state(out, state);
+}
+
+// sha256(sha256(in)) of one 64 byte input. The input is consumed before
+// the overlapping output is written.
+static void double_hash_64_single(uint8_t* out, const uint8_t* in,
+    transform_function transform)
+{
+    uint32_t state[state_size];
+    std::memcpy(state, initial_state, sizeof(initial_state));
+    transform(state, in, 1);
+    transform(state, padding_64, 1);
+    hash_digest_state(out, state, transform);
+}
+
+// Implementation selection.
+// ----------------------------------------------------------------------------
+
+#if defined(WITH_SHA256_SSE41) || defined(WITH_SHA256_AVX2) || \
+    defined(WITH_SHA256_SHANI)
+
+// Known answer checks against the portable transform, so a backend that
+// the processor reports but does not compute correctly is never selected.
+static const size_t self_test_blocks = 8;
+
+static void self_test_data(uint8_t* data)
+{
+    for (size_t index = 0; index < self_test_blocks * block_size; ++index)
+        data[index] = uint8_t(index * 7 + 1);
+}
+
+static bool transform_agrees(transform_function transform)
+{
+    uint8_t blocks[self_test_blocks * block_size];
+    self_test_data(blocks);
+
+    uint32_t expected[state_size];
+    uint32_t actual[state_size];
+    std::memcpy(expected, initial_state, sizeof(initial_state));
+    std::memcpy(actual, initial_state, sizeof(initial_state));
+    transform_portable(expected, blocks, self_test_blocks);
+    transform(actual, blocks, self_test_blocks);
+    return std::memcmp(expected, actual, sizeof(expected)) == 0;
+}
+
+static bool lanes_agree(lanes_function lanes, size_t count)
+{
+    uint8_t in[self_test_blocks * block_size];
+    self_test_data(in);
+
+    uint8_t expected[self_test_blocks * digest_size];
+    uint8_t actual[self_test_blocks * digest_size];
+    for (size_t lane = 0; lane < count; ++lane)
+        double_hash_64_single(expected + lane * digest_size,
+            in + lane * block_size, transform_portable);
+
+    lanes(actual, in);
+    return std::memcmp(expected, actual, count * digest_size) == 0;
+}
+#endif
+
+struct engine
+{
+    std::string name;
+    transform_function transform;
+
+    // Multi-buffer double hashes of 64 byte inputs, widest first, null if
+    // not available.
+    lanes_function wide;
+    size_t wide_lanes;
+    lanes_function narrow;
+    size_t narrow_lanes;
+};
+
+#if defined(WITH_SHA256_SSE41) || defined(WITH_SHA256_AVX2) || \
+    defined(WITH_SHA256_SHANI)
+static void cpuid(uint32_t leaf, uint32_t& eax, uint32_t& ebx, uint32_t& ecx,
+    uint32_t& edx)
+{
+#ifdef _MSC_VER
+    int registers[4];
+    __cpuidex(registers, static_cast<int>(leaf), 0);
+    eax = static_cast<uint32_t>(registers[0]);
+    ebx = static_cast<uint32_t>(registers[1]);
+    ecx = static_cast<uint32_t>(registers[2]);
+    edx = static_cast<uint32_t>(registers[3]);
+#else
+    __cpuid_count(leaf, 0, eax, ebx, ecx, edx);
+#endif
+}
+
+static uint32_t xgetbv()
+{
+#ifdef _MSC_VER
+    return static_cast<uint32_t>(_xgetbv(0));
+#else
+    uint32_t low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0));
+    return low;
+#endif
+}
+#endif
+
+static engine select_engine()
+{
+    engine selected{ "portable", transform_portable, nullptr, 0, nullptr, 0 };
+
+#if defined(WITH_SHA256_SSE41) || defined(WITH_SHA256_AVX2) || \
+    defined(WITH_SHA256_SHANI)
+    uint32_t eax, ebx, ecx, edx;
+    cpuid(0, eax, ebx, ecx, edx);
+    const auto max_leaf = eax;
+    if (max_leaf < 1)
+        return selected;
+
+    cpuid(1, eax, ebx, ecx, edx);
+    const auto sse41 = (ecx & (1u << 19)) != 0;
+    const auto os_saves_ymm = [ecx]()
+    {
+        // OSXSAVE and AVX, then the OS must save the xmm and ymm registers.
+        if ((ecx & (1u << 27)) == 0 || (ecx & (1u << 28)) == 0)
+            return false;
+
+        return (xgetbv() & 0x6) == 0x6;
+    }();
+
+    // Leaf 7 holds the avx2 and sha extension flags, older processors
+    // without it can still have sse4.1.
+    auto avx2 = false;
+    auto shani = false;
+    if (max_leaf >= 7)
+    {
+        cpuid(7, eax, ebx, ecx, edx);
+        avx2 = os_saves_ymm && (ebx & (1u << 5)) != 0;
+        shani = sse41 && (ebx & (1u << 29)) != 0;
+    }
+
+    // Measured on a processor with all three, eight generic lanes outrun
+    // the SHA extensions for 64 byte inputs, which take three transforms
+    // each, so the extensions serve the single stream transform.
+#ifdef WITH_SHA256_SHANI
+    if (shani && transform_agrees(transform_shani))
+    {
+        selected.name = "shani";
+        selected.transform = transform_shani;
+    }
+#endif
+
+#ifdef WITH_SHA256_AVX2
+    if (avx2 && lanes_agree(double_hash_64_avx2, avx2_lanes))
+    {
+        selected.name += ",avx2";
+        selected.wide = double_hash_64_avx2;
+        selected.wide_lanes = avx2_lanes;
+    }
+#endif
+
+#ifdef WITH_SHA256_SSE41
+    if (sse41 && lanes_agree(double_hash_64_sse41, sse41_lanes))
+    {
+        selected.name += ",sse41";
+        selected.narrow = double_hash_64_sse41;
+        selected.narrow_lanes = sse41_lanes;
+    }
+#endif
+
+    (void)avx2;
+    (void)shani;
+#endif
+
+    return selected;
+}
+
+static const engine& get_engine()
+{
+    static const auto instance = select_engine();
+    return instance;
+}
+
+// Hashing.
+// ----------------------------------------------------------------------------
+
+const char* implementation()
+{
+    return get_engine().name.c_str();
+}
+
+void transform(uint32_t* state, const uint8_t* blocks, size_t count)
+{
+    get_engine().transform(state, blocks, count);
+}
+
+void double_hash(uint8_t* out, const uint8_t* data, size_t size)
+{
+    const auto transform = get_engine().transform;
+    uint32_t state[state_size];
+    std::memcpy(state, initial_state, sizeof(initial_state));
+
+    const auto blocks = size / block_size;
+    transform(state, data, blocks);
+
+    // The remainder and padding take one block, or two if the 64 bit
+    // length does not fit after the remainder.
+    const auto remainder = size % block_size;
+    const auto tail_blocks = remainder < block_size - 8 ? 1 : 2;
+    uint8_t tail[2 * block_size] = { 0 };
+    if (remainder > 0)
+        std::memcpy(tail, data + blocks * block_size, remainder);
+
+    tail[remainder] = 0x80;
+
+    const auto bits = uint64_t(size) * 8;
+    auto length = tail + tail_blocks * block_size - 8;
+    for (size_t byte = 0; byte < 8; ++byte)
+        length[byte] = uint8_t(bits >> (56 - 8 * byte));
+
+    transform(state, tail, tail_blocks);
+    hash_digest_state(out, state, transform);
+}
+
+void double_hash_64(uint8_t* out, const uint8_t* in, size_t count)
+{
+    const auto& selected = get_engine();
+
+    if (selected.wide != nullptr)
+        for (; count >= selected.wide_lanes; count -= selected.wide_lanes)
+        {
+            selected.wide(out, in);
+            out += selected.wide_lanes * digest_size;
+            in += selected.wide_lanes * block_size;
+        }
+
+    if (selected.narrow != nullptr)
+        for (; count >= selected.narrow_lanes; count -= selected.narrow_lanes)
+        {
+            selected.narrow(out, in);
+            out += selected.narrow_lanes * digest_size;
+            in += selected.narrow_lanes * block_size;
+        }
+
+    for (; count > 0; --count, out += digest_size, in += block_size)
+        double_hash_64_single(out, in, selected.transform);
+}
+
+} // namespace sha256
+} // namespace libbitcoin
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SHA256_ENGINE_HPP
+#define MVS_SHA256_ENGINE_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace libbitcoin {
+namespace sha256 {
+
+/**
+ * The sha256 compression function with runtime selection of the fastest
+ * implementation for the processor. Backends other than the portable one
+ * are built only when the compiler supports their instruction set, see
+ * src/lib/bitcoin/CMakeLists.txt.
+ */
+
+static const size_t block_size = 64;
+static const size_t digest_size = 32;
+static const size_t state_size = 8;
+
+typedef void (*transform_function)(uint32_t* state, const uint8_t* blocks,
+    size_t count);
+
+/// Hashes of lane count 64 byte inputs, lanes laid out consecutively.
+typedef void (*lanes_function)(uint8_t* out, const uint8_t* in);
+
+/// Compress count consecutive blocks into the state.
+void transform(uint32_t* state, const uint8_t* blocks, size_t count);
+
+/// sha256(sha256(data)) of arbitrary data.
+void double_hash(uint8_t* out, const uint8_t* data, size_t size);
+
+/// sha256(sha256(in)) of count consecutive 64 byte inputs, as in merkle
+/// trees. The output may overlap the start of the input.
+void double_hash_64(uint8_t* out, const uint8_t* in, size_t count);
+
+/// The name of the selected implementation, for diagnostics.
+const char* implementation();
+
+#ifdef WITH_SHA256_SSE41
+void double_hash_64_sse41(uint8_t* out, const uint8_t* in);
+static const size_t sse41_lanes = 4;
+#endif
+
+#ifdef WITH_SHA256_AVX2
+void double_hash_64_avx2(uint8_t* out, const uint8_t* in);
+static const size_t avx2_lanes = 8;
+#endif
+
+#ifdef WITH_SHA256_SHANI
+void transform_shani(uint32_t* state, const uint8_t* blocks, size_t count);
+#endif
+
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,272 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_SHA256_LANES_HPP
+#define MVS_SHA256_LANES_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// Included only by the backend translation units, each compiled with its own
+// instruction set flags. Everything here must have internal linkage so that
+// code generated for one instruction set is never linked into another.
+
+namespace libbitcoin {
+namespace sha256 {
+namespace {
+
+static const uint32_t initial_state[8]
+{
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+    0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+static const uint32_t round_constants[64]
+{
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+// Round constants plus the message schedule of the padding block that
+// follows a 64 byte message, which is the same for every input.
+static const uint32_t padding_64_schedule[64]
+{
+    0xc28a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf374,
+    0x649b69c1, 0xf0fe4786, 0x0fe1edc6, 0x240cf254,
+    0x4fe9346f, 0x6cc984be, 0x61b9411e, 0x16f988fa,
+    0xf2c65152, 0xa88e5a6d, 0xb019fc65, 0xb9d99ec7,
+    0x9a1231c3, 0xe70eeaa0, 0xfdb1232b, 0xc7353eb0,
+    0x3069bad5, 0xcb976d5f, 0x5a0f118f, 0xdc1eeefd,
+    0x0a35b689, 0xde0b7a04, 0x58f4ca9d, 0xe15d5b16,
+    0x007f3e86, 0x37088980, 0xa507ea32, 0x6fab9537,
+    0x17406110, 0x0d8cd6f1, 0xcdaa3b6d, 0xc0bbbe37,
+    0x83613bda, 0xdb48a363, 0x0b02e931, 0x6fd15ca7,
+    0x521afaca, 0x31338431, 0x6ed41a95, 0x6d437890,
+    0xc39c91f2, 0x9eccabbd, 0xb5c9a0e6, 0x532fb63c,
+    0xd2c741c6, 0x07237ea3, 0xa4954b68, 0x4c191d76
+};
+
+static inline uint32_t read_big_endian(const uint8_t* in)
+{
+    return (uint32_t(in[0]) << 24) | (uint32_t(in[1]) << 16) |
+        (uint32_t(in[2]) << 8) | uint32_t(in[3]);
+}
+
+static inline void write_big_endian(uint8_t* out, uint32_t value)
+{
+    out[0] = uint8_t(value >> 24);
+    out[1] = uint8_t(value >> 16);
+    out[2] = uint8_t(value >> 8);
+    out[3] = uint8_t(value);
+}
+
+/// Double sha256 of Vector::lanes 64 byte inputs at once, one input per
+/// vector lane. Vector provides the 32 bit lane operations.
+template <typename Vector>
+class lanes
+{
+public:
+    typedef typename Vector::word word;
+
+    static void double_hash_64(uint8_t* out, const uint8_t* in)
+    {
+        word state[8];
+        word message[16];
+
+        // All input is read before any output is written.
+        for (size_t index = 0; index < 16; ++index)
+            message[index] = Vector::load(in, 4 * index);
+
+        initialize(state);
+        compress(state, message);
+        add_initial(state);
+
+        // The padding block is the same for all 64 byte messages.
+        word saved[8];
+        for (size_t index = 0; index < 8; ++index)
+            saved[index] = state[index];
+
+        compress_padding(state);
+        for (size_t index = 0; index < 8; ++index)
+            message[index] = Vector::add(state[index], saved[index]);
+
+        // Second hash of the 32 byte digest.
+        message[8] = Vector::set(0x80000000);
+        for (size_t index = 9; index < 15; ++index)
+            message[index] = Vector::set(0);
+        message[15] = Vector::set(256);
+
+        initialize(state);
+        compress(state, message);
+        add_initial(state);
+
+        for (size_t index = 0; index < 8; ++index)
+            Vector::store(out, 4 * index, state[index]);
+    }
+
+private:
+    template <int Bits>
+    static word rotate(word value)
+    {
+        return Vector::bit_or(Vector::template shift_right<Bits>(value),
+            Vector::template shift_left<32 - Bits>(value));
+    }
+
+    static word xor3(word first, word second, word third)
+    {
+        return Vector::bit_xor(Vector::bit_xor(first, second), third);
+    }
+
+    static word big_sigma0(word value)
+    {
+        return xor3(rotate<2>(value), rotate<13>(value), rotate<22>(value));
+    }
+
+    static word big_sigma1(word value)
+    {
+        return xor3(rotate<6>(value), rotate<11>(value), rotate<25>(value));
+    }
+
+    static word sigma0(word value)
+    {
+        return xor3(rotate<7>(value), rotate<18>(value),
+            Vector::template shift_right<3>(value));
+    }
+
+    static word sigma1(word value)
+    {
+        return xor3(rotate<17>(value), rotate<19>(value),
+            Vector::template shift_right<10>(value));
+    }
+
+    static word choose(word x, word y, word z)
+    {
+        return Vector::bit_xor(z, Vector::bit_and(x, Vector::bit_xor(y, z)));
+    }
+
+    static word majority(word x, word y, word z)
+    {
+        return Vector::bit_or(Vector::bit_and(x, y),
+            Vector::bit_and(z, Vector::bit_or(x, y)));
+    }
+
+    static void round(word a, word b, word c, word& d, word e, word f,
+        word g, word& h, word constant_and_message)
+    {
+        const auto t1 = Vector::add(Vector::add(h, big_sigma1(e)),
+            Vector::add(choose(e, f, g), constant_and_message));
+        const auto t2 = Vector::add(big_sigma0(a), majority(a, b, c));
+        d = Vector::add(d, t1);
+        h = Vector::add(t1, t2);
+    }
+
+    static void initialize(word* state)
+    {
+        for (size_t index = 0; index < 8; ++index)
+            state[index] = Vector::set(initial_state[index]);
+    }
+
+    static void add_initial(word* state)
+    {
+        for (size_t index = 0; index < 8; ++index)
+            state[index] = Vector::add(state[index],
+                Vector::set(initial_state[index]));
+    }
+
+    // Round constant plus message word, extending the message schedule in
+    // place beyond the first sixteen rounds.
+    static word schedule(word* message, size_t round)
+    {
+        auto& word_ = message[round % 16];
+
+        if (round >= 16)
+            word_ = Vector::add(Vector::add(word_,
+                sigma1(message[(round - 2) % 16])),
+                Vector::add(message[(round - 7) % 16],
+                    sigma0(message[(round - 15) % 16])));
+
+        return Vector::add(word_, Vector::set(round_constants[round]));
+    }
+
+    static void compress(word* state, word* message)
+    {
+        auto a = state[0], b = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+
+        for (size_t index = 0; index < 64; index += 8)
+        {
+            round(a, b, c, d, e, f, g, h, schedule(message, index + 0));
+            round(h, a, b, c, d, e, f, g, schedule(message, index + 1));
+            round(g, h, a, b, c, d, e, f, schedule(message, index + 2));
+            round(f, g, h, a, b, c, d, e, schedule(message, index + 3));
+            round(e, f, g, h, a, b, c, d, schedule(message, index + 4));
+            round(d, e, f, g, h, a, b, c, schedule(message, index + 5));
+            round(c, d, e, f, g, h, a, b, schedule(message, index + 6));
+            round(b, c, d, e, f, g, h, a, schedule(message, index + 7));
+        }
+
+        state[0] = a; state[1] = b; state[2] = c; state[3] = d;
+        state[4] = e; state[5] = f; state[6] = g; state[7] = h;
+    }
+
+    static void compress_padding(word* state)
+    {
+        auto a = state[0], b = state[1], c = state[2], d = state[3];
+        auto e = state[4], f = state[5], g = state[6], h = state[7];
+        const auto k = padding_64_schedule;
+
+        for (size_t index = 0; index < 64; index += 8)
+        {
+            round(a, b, c, d, e, f, g, h, Vector::set(k[index + 0]));
+            round(h, a, b, c, d, e, f, g, Vector::set(k[index + 1]));
+            round(g, h, a, b, c, d, e, f, Vector::set(k[index + 2]));
+            round(f, g, h, a, b, c, d, e, Vector::set(k[index + 3]));
+            round(e, f, g, h, a, b, c, d, Vector::set(k[index + 4]));
+            round(d, e, f, g, h, a, b, c, Vector::set(k[index + 5]));
+            round(c, d, e, f, g, h, a, b, Vector::set(k[index + 6]));
+            round(b, c, d, e, f, g, h, a, Vector::set(k[index + 7]));
+        }
+
+        state[0] = a; state[1] = b; state[2] = c; state[3] = d;
+        state[4] = e; state[5] = f; state[6] = g; state[7] = h;
+    }
+};
+
+} // namespace
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
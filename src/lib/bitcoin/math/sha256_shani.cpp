@@ -0,0 +1,104 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "sha256_engine.hpp"
+
+#ifdef WITH_SHA256_SHANI
+
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "sha256_lanes.hpp"
+
+namespace libbitcoin {
+namespace sha256 {
+
+// The SHA extensions keep the state as two vectors of ABEF and CDGH and
+// run two rounds per instruction, four message words at a time. Compiled
+// with -msse4.1 -msha.
+void transform_shani(uint32_t* state, const uint8_t* blocks, size_t count)
+{
+    const auto byte_order = _mm_set_epi64x(0x0c0d0e0f08090a0bull,
+        0x0405060700010203ull);
+
+    // Load the state, reordering DCBA and HGFE to ABEF and CDGH.
+    auto dcba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state));
+    auto hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i*>(state + 4));
+    const auto cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    const auto efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    auto abef = _mm_alignr_epi8(cdab, efgh, 8);
+    auto cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for (; count > 0; --count, blocks += block_size)
+    {
+        const auto abef_saved = abef;
+        const auto cdgh_saved = cdgh;
+        __m128i message[4];
+
+        for (size_t quad = 0; quad < 16; ++quad)
+        {
+            auto& current = message[quad % 4];
+
+            if (quad < 4)
+                current = _mm_shuffle_epi8(_mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(blocks + 16 * quad)),
+                    byte_order);
+
+            auto words = _mm_add_epi32(current, _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(round_constants + 4 * quad)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, words);
+
+            // Complete the schedule of the message words four rounds ahead.
+            if (quad >= 3 && quad < 15)
+            {
+                auto& next = message[(quad + 1) % 4];
+                const auto previous = message[(quad + 3) % 4];
+                next = _mm_add_epi32(next,
+                    _mm_alignr_epi8(current, previous, 4));
+                next = _mm_sha256msg2_epu32(next, current);
+            }
+
+            words = _mm_shuffle_epi32(words, 0x0e);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, words);
+
+            // Start the schedule of the message words twelve rounds ahead.
+            if (quad >= 1 && quad < 13)
+            {
+                auto& previous = message[(quad + 3) % 4];
+                previous = _mm_sha256msg1_epu32(previous, current);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abef_saved);
+        cdgh = _mm_add_epi32(cdgh, cdgh_saved);
+    }
+
+    // Store the state, reordering ABEF and CDGH to DCBA and HGFE.
+    const auto feba = _mm_shuffle_epi32(abef, 0x1b);
+    const auto dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    dcba = _mm_blend_epi16(feba, dchg, 0xf0);
+    hgfe = _mm_alignr_epi8(dchg, feba, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state), dcba);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(state + 4), hgfe);
+}
+
+} // namespace sha256
+} // namespace libbitcoin
+
+#endif
@@ -60,7 +60,7 @@ transaction_message transaction_message::factory_from_data(
 }
 
 transaction_message::transaction_message()
-  : transaction(), originator_(0)
+  : transaction(), originator_(0), fee_(0)
 {
 }
 
@@ -78,7 +78,8 @@ transaction_message::transaction_message(const transaction_message& other)
 
 transaction_message::transaction_message(uint32_t version, uint32_t locktime,
     const chain::input::list& inputs, const chain::output::list& outputs)
-  : transaction(version, locktime, inputs, outputs), originator_(0)
+  : transaction(version, locktime, inputs, outputs), originator_(0),
+    fee_(0)
 {
 }
 
@@ -100,7 +101,8 @@ transaction_message::transaction_message(uint32_t version, uint32_t locktime,
     chain::input::list&& inputs, chain::output::list&& outputs)
   : transaction(version, locktime, std::forward<chain::input::list>(inputs),
         std::forward<chain::output::list>(outputs)),
-    originator_(0)
+    originator_(0),
+    fee_(0)
 {
 }
 
@@ -112,6 +114,7 @@ transaction_message& transaction_message::operator=(
     inputs = std::move(other.inputs);
     outputs = std::move(other.outputs);
     originator_ = other.originator_;
+    fee_ = other.fee_;
     return *this;
 }
 
@@ -166,5 +169,15 @@ void transaction_message::set_originator(uint64_t value)
     originator_ = value;
 }
 
+uint64_t transaction_message::fee() const
+{
+    return fee_;
+}
+
+void transaction_message::set_fee(uint64_t value)
+{
+    fee_ = value;
+}
+
 } // namspace message
 } // namspace libbitcoin
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/hash_cache.hpp>
+
+#include <atomic>
+#include <cstdint>
+
+namespace libbitcoin {
+
+hash_cache::hash_cache()
+  : state_(empty)
+{
+}
+
+hash_cache::hash_cache(const hash_cache&)
+  : state_(empty)
+{
+}
+
+hash_cache& hash_cache::operator=(const hash_cache&)
+{
+    reset();
+    return *this;
+}
+
+bool hash_cache::get(hash_digest& out) const
+{
+    // Acquire pairs with the release in set, making the hash visible.
+    if (state_.load(std::memory_order_acquire) != ready)
+        return false;
+
+    out = hash_;
+    return true;
+}
+
+void hash_cache::set(const hash_digest& hash) const
+{
+    uint8_t expected = empty;
+    if (!state_.compare_exchange_strong(expected, writing,
+        std::memory_order_acquire))
+        return;
+
+    hash_ = hash;
+    state_.store(ready, std::memory_order_release);
+}
+
+void hash_cache::reset()
+{
+    state_.store(empty, std::memory_order_relaxed);
+}
+
+} // namespace libbitcoin
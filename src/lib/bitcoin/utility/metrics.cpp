@@ -0,0 +1,289 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/bitcoin/utility/metrics.hpp>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <metaverse/bitcoin/utility/assert.hpp>
+
+namespace libbitcoin {
+
+// Escape a label value for the text exposition format.
+static std::string escape(const std::string& value)
+{
+    std::string out;
+    out.reserve(value.size());
+
+    for (const auto character: value)
+    {
+        if (character == '\\' || character == '"')
+            out += '\\';
+
+        if (character == '\n')
+            out += "\\n";
+        else
+            out += character;
+    }
+
+    return out;
+}
+
+// Join a label set and an additional label.
+static std::string join(const std::string& labels, const std::string& label)
+{
+    if (labels.empty())
+        return "{" + label + "}";
+
+    return labels.substr(0, labels.size() - 1) + "," + label + "}";
+}
+
+// metric_counter
+// ----------------------------------------------------------------------------
+
+metric_counter::metric_counter()
+  : value_(0)
+{
+}
+
+uint64_t metric_counter::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+void metric_counter::write(std::ostream& out, const std::string& name,
+    const std::string& labels) const
+{
+    out << name << labels << " " << value() << "\n";
+}
+
+// metric_gauge
+// ----------------------------------------------------------------------------
+
+metric_gauge::metric_gauge()
+  : value_(0)
+{
+}
+
+int64_t metric_gauge::value() const
+{
+    return value_.load(std::memory_order_relaxed);
+}
+
+void metric_gauge::write(std::ostream& out, const std::string& name,
+    const std::string& labels) const
+{
+    out << name << labels << " " << value() << "\n";
+}
+
+// metric_histogram
+// ----------------------------------------------------------------------------
+
+const metric_histogram::bounds metric_histogram::seconds
+{
+    0.0001, 0.0005, 0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 30
+};
+
+metric_histogram::metric_histogram(const bounds& upper_bounds)
+  : bounds_(upper_bounds),
+    buckets_(new std::atomic<uint64_t>[upper_bounds.size() + 1]),
+    count_(0),
+    sum_(0)
+{
+    BITCOIN_ASSERT(std::is_sorted(bounds_.begin(), bounds_.end()));
+
+    for (size_t bucket = 0; bucket <= bounds_.size(); ++bucket)
+        buckets_[bucket].store(0);
+}
+
+void metric_histogram::observe(double value)
+{
+    // The last bucket is +Inf.
+    const auto bucket = std::lower_bound(bounds_.begin(), bounds_.end(),
+        value) - bounds_.begin();
+
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto sum = sum_.load(std::memory_order_relaxed);
+    while (!sum_.compare_exchange_weak(sum, sum + value,
+        std::memory_order_relaxed));
+}
+
+uint64_t metric_histogram::count() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+double metric_histogram::sum() const
+{
+    return sum_.load(std::memory_order_relaxed);
+}
+
+void metric_histogram::write(std::ostream& out, const std::string& name,
+    const std::string& labels) const
+{
+    // Buckets are cumulative in the exposition format.
+    uint64_t cumulative = 0;
+    for (size_t bucket = 0; bucket < bounds_.size(); ++bucket)
+    {
+        cumulative += buckets_[bucket].load(std::memory_order_relaxed);
+        std::ostringstream bound;
+        bound << bounds_[bucket];
+        out << name << "_bucket" << join(labels, "le=\"" + bound.str() + "\"")
+            << " " << cumulative << "\n";
+    }
+
+    cumulative += buckets_[bounds_.size()].load(std::memory_order_relaxed);
+    out << name << "_bucket" << join(labels, "le=\"+Inf\"") << " "
+        << cumulative << "\n";
+    out << name << "_sum" << labels << " " << sum() << "\n";
+    out << name << "_count" << labels << " " << cumulative << "\n";
+}
+
+// metric_family_base
+// ----------------------------------------------------------------------------
+
+metric_family_base::metric_family_base(const std::string& name,
+    const std::string& help, const std::string& type, const std::string& label)
+  : name_(name), help_(help), type_(type), label_(label)
+{
+}
+
+metric_family_base::~metric_family_base()
+{
+}
+
+const std::string& metric_family_base::type() const
+{
+    return type_;
+}
+
+void metric_family_base::write(std::ostream& out) const
+{
+    out << "# HELP " << name_ << " " << help_ << "\n";
+    out << "# TYPE " << name_ << " " << type_ << "\n";
+    write_values(out);
+}
+
+std::string metric_family_base::labels(const std::string& value) const
+{
+    if (label_.empty())
+        return "";
+
+    return "{" + label_ + "=\"" + escape(value) + "\"}";
+}
+
+// metrics
+// ----------------------------------------------------------------------------
+
+typedef std::map<std::string, std::unique_ptr<metric_family_base>> family_map;
+
+static shared_mutex& registry_mutex()
+{
+    static shared_mutex mutex;
+    return mutex;
+}
+
+static family_map& registry()
+{
+    static family_map families;
+    return families;
+}
+
+metric_family_base& metrics::find(const std::string& name,
+    std::function<metric_family_base*()> make)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(registry_mutex());
+
+    auto& family = registry()[name];
+    if (!family)
+        family.reset(make());
+
+    return *family;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+metrics::counter_family& metrics::counter(const std::string& name,
+    const std::string& help, const std::string& label)
+{
+    auto& family = find(name, [&]()
+    {
+        return new counter_family(name, help, "counter", label, []()
+        {
+            return new metric_counter;
+        });
+    });
+
+    BITCOIN_ASSERT_MSG(family.type() == "counter", "metric type mismatch");
+    return static_cast<counter_family&>(family);
+}
+
+metrics::gauge_family& metrics::gauge(const std::string& name,
+    const std::string& help, const std::string& label)
+{
+    auto& family = find(name, [&]()
+    {
+        return new gauge_family(name, help, "gauge", label, []()
+        {
+            return new metric_gauge;
+        });
+    });
+
+    BITCOIN_ASSERT_MSG(family.type() == "gauge", "metric type mismatch");
+    return static_cast<gauge_family&>(family);
+}
+
+metrics::histogram_family& metrics::histogram(const std::string& name,
+    const std::string& help, const std::string& label,
+    const metric_histogram::bounds& bounds)
+{
+    auto& family = find(name, [&]()
+    {
+        return new histogram_family(name, help, "histogram", label, [bounds]()
+        {
+            return new metric_histogram(bounds);
+        });
+    });
+
+    BITCOIN_ASSERT_MSG(family.type() == "histogram", "metric type mismatch");
+    return static_cast<histogram_family&>(family);
+}
+
+std::string metrics::to_text()
+{
+    std::ostringstream out;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(registry_mutex());
+
+    for (const auto& family: registry())
+        family.second->write(out);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out.str();
+}
+
+} // namespace libbitcoin
@@ -58,6 +58,7 @@ block_chain_impl::block_chain_impl(threadpool& pool,
     ////read_dispatch_(pool, NAME),
     ////write_dispatch_(pool, NAME),
     transaction_pool_(pool, *this, chain_settings),
+    verified_scripts_(chain_settings.script_cache_capacity),
     database_(database_settings)
 {
 }
@@ -91,6 +92,11 @@ transaction_pool& block_chain_impl::pool()
     return transaction_pool_;
 }
 
+script_cache& block_chain_impl::verified_scripts()
+{
+    return verified_scripts_;
+}
+
 const settings& block_chain_impl::chain_settings() const
 {
     return settings_;
@@ -1244,7 +1250,8 @@ std::shared_ptr<business_address_asset::list> block_chain_impl::get_account_asse
     auto sp_asset_vec = get_account_assets(name, kind);
     auto ret_vector = std::make_shared<business_address_asset::list>();
 
-    const auto action = [&](const business_address_asset& addr_asset)
+    // The fetched list is discarded, so matches are moved out of it.
+    const auto action = [&](business_address_asset& addr_asset)
     {
         if (addr_asset.detail.get_symbol() == asset_name)
             ret_vector->emplace_back(std::move(addr_asset));
@@ -1261,7 +1268,8 @@ std::shared_ptr<business_address_asset::list> block_chain_impl::get_account_asse
     auto sp_asset_vec = get_account_assets(name);
     auto ret_vector = std::make_shared<business_address_asset::list>();
 
-    const auto action = [&](const business_address_asset& addr_asset)
+    // The fetched list is discarded, so matches are moved out of it.
+    const auto action = [&](business_address_asset& addr_asset)
     {
         if (addr_asset.detail.get_symbol() == asset_name)
             ret_vector->emplace_back(std::move(addr_asset));
@@ -1526,7 +1534,7 @@ uint64_t block_chain_impl::get_address_asset_volume(const std::string& addr, con
         if ((row.spend.hash == null_hash)
             && get_transaction(tx_temp, tx_height, row.output.hash))
         {
-            auto output = tx_temp.outputs.at(row.output.index);
+            const auto& output = tx_temp.outputs.at(row.output.index);
             if ((output.is_asset_transfer() || output.is_asset_issue() || output.is_asset_secondaryissue())) {
                 if (output.get_asset_symbol() == asset) {
                     asset_volume += output.get_asset_amount();
@@ -2424,7 +2432,7 @@ bool block_chain_impl::get_tx_inputs_etp_value (chain::transaction& tx, uint64_t
     for (auto& each : tx.inputs) {
 
         if (get_transaction(each.previous_output.hash, tx_temp, tx_height)) {
-            auto output = tx_temp.outputs.at(each.previous_output.index);
+            const auto& output = tx_temp.outputs.at(each.previous_output.index);
             etp_val += output.value;
         } else {
             log::debug("get_tx_inputs_etp_value=")<<each.to_string(true);
@@ -0,0 +1,94 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/consensus_context.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/export.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace chain;
+
+consensus_context::consensus_context(const chain::transaction& tx)
+  : tx_(tx)
+{
+}
+
+consensus_context::~consensus_context()
+{
+}
+
+const chain::transaction& consensus_context::transaction() const
+{
+    return tx_;
+}
+
+bool consensus_context::verify(const script& prevout_script,
+    size_t input_index, uint32_t flags) const
+{
+    BITCOIN_ASSERT(input_index <= max_uint32);
+    BITCOIN_ASSERT(input_index < tx_.inputs.size());
+    const auto input_index32 = static_cast<uint32_t>(input_index);
+
+#ifdef WITH_CONSENSUS
+    using namespace bc::consensus;
+    const auto previous_output_script = prevout_script.to_data(false);
+
+    // Convert native flags to libbitcoin-consensus flags.
+    uint32_t consensus_flags = verify_flags_none;
+
+    if ((flags & script_context::bip16_enabled) != 0)
+        consensus_flags |= verify_flags_p2sh;
+
+    if ((flags & script_context::bip65_enabled) != 0)
+        consensus_flags |= verify_flags_checklocktimeverify;
+
+    if ((flags & script_context::bip66_enabled) != 0)
+        consensus_flags |= verify_flags_dersig;
+
+    if ((flags & script_context::attenuation_enabled) != 0)
+        consensus_flags |= verify_flags_checkattenuationverify;
+
+    // Parse on first use, inputs found in the script cache never need it.
+    if (!context_)
+    {
+        const auto data = tx_.to_data();
+        context_.reset(new transaction_context(data.data(), data.size()));
+    }
+
+    const auto result = context_->verify_script(previous_output_script.data(),
+        previous_output_script.size(), input_index32, consensus_flags);
+
+    return result == verify_result::verify_result_eval_true;
+#else
+    // Copy the const prevout script so it can be run.
+    auto previous_output_script = prevout_script;
+    const auto& current_input_script = tx_.inputs[input_index].script;
+
+    return script::verify(current_input_script, previous_output_script, tx_,
+        input_index32, flags);
+#endif
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
@@ -33,6 +33,7 @@
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/simple_chain.hpp>
 #include <metaverse/blockchain/validate_block_impl.hpp>
+#include <metaverse/consensus/miner/MinerAux.h>
 #include <metaverse/bitcoin/chain/header.hpp>
 #include <metaverse/node/protocols/protocol_block_out.hpp>
 #include <metaverse/bitcoin/wallet/payment_address.hpp>
@@ -113,23 +114,48 @@ code organizer::verify(uint64_t fork_point,
         orphan_index, height, *current_block, use_testnet_rules_, checkpoints_,
             callback);
 
+    static auto& phases = metrics::histogram("mvs_block_validation_seconds",
+        "Block validation time by phase.", "phase");
+    static auto& check_seconds = phases.get("check_block");
+    static auto& accept_seconds = phases.get("accept_block");
+    static auto& connect_seconds = phases.get("connect_block");
+    static auto& blocks = metrics::counter("mvs_block_validation_total",
+        "Blocks validated by result.", "result");
+
+    code ec;
+
     // Checks that are independent of the chain.
-    auto ec = validate.check_block(static_cast<blockchain::block_chain_impl&>(this->chain_));
+    check_seconds.observe_duration(timer<asio::microseconds>::duration([&]()
+    {
+        ec = validate.check_block(static_cast<blockchain::block_chain_impl&>(this->chain_));
+    }));
 
     if (ec)
+    {
+        blocks.get("invalid").increment();
         return ec;
+    }
 
     validate.initialize_context();
 
     // Checks that are dependent on height and preceding blocks.
-    ec = validate.accept_block();
+    accept_seconds.observe_duration(timer<asio::microseconds>::duration([&]()
+    {
+        ec = validate.accept_block();
+    }));
 
     if (ec)
+    {
+        blocks.get("invalid").increment();
         return ec;
+    }
 
     // Start strict validation if past last checkpoint.
     if (!strict(fork_point))
+    {
+        blocks.get("checkpointed").increment();
         return ec;
+    }
 
     const auto total_inputs = count_inputs(*current_block);
     const auto total_transactions = current_block->transactions.size();
@@ -151,8 +177,10 @@ code organizer::verify(uint64_t fork_point,
     };
 
     // Execute the timed validation.
-    const auto elapsed = timer<std::chrono::milliseconds>::duration(timed);
-    const auto ms_per_block = static_cast<float>(elapsed.count());
+    const auto elapsed = timer<asio::microseconds>::duration(timed);
+    connect_seconds.observe_duration(elapsed);
+    blocks.get(ec ? "invalid" : "valid").increment();
+    const auto ms_per_block = static_cast<float>(elapsed.count()) / 1000;
     const auto ms_per_input = ms_per_block / total_inputs;
     const auto seconds_per_block = ms_per_block / 1000;
     const auto verified = ec ? "unverified" : "verified";
@@ -248,6 +276,39 @@ static std::set<std::pair<uint64_t, std::string>> exception_blocks {
 void organizer::replace_chain(uint64_t fork_index,
     block_detail::list& orphan_chain)
 {
+    // Compare the difficulty of the 2 forks (original and orphan)
+    const auto begin_index = fork_index + 1;
+
+    u256 main_work;
+    DEBUG_ONLY(auto result =) chain_.get_difficulty(main_work, begin_index);
+    BITCOIN_ASSERT(result);
+
+    // The work claimed by the headers bounds the work of any valid prefix,
+    // so a fork that cannot win is set aside before any block is verified.
+    // Bits are only counted behind a valid seal and difficulty, otherwise a
+    // peer could claim any work it likes.
+    u256 claimed_work = 0;
+    for (uint64_t orphan = 0; orphan < orphan_chain.size(); ++orphan)
+    {
+        auto& header = orphan_chain[orphan]->actual()->header;
+        if (!orphan_chain[orphan]->get_is_checked_work_proof())
+        {
+            chain::header parent;
+            if (orphan != 0)
+                parent = orphan_chain[orphan - 1]->actual()->header;
+            else if (!chain_.get_header(parent, fork_index))
+                break;
+
+            if (!MinerAux::verifySeal(header, parent))
+                break;
+        }
+
+        claimed_work += block_work(header.bits);
+    }
+
+    if (insufficient_work(orphan_chain, begin_index, claimed_work, main_work))
+        return;
+
     u256 orphan_work = 0;
 
     for (uint64_t orphan = 0; orphan < orphan_chain.size(); ++orphan)
@@ -297,25 +358,10 @@ void organizer::replace_chain(uint64_t fork_index,
         orphan_work += block_work(orphan_block->header.bits);
     }
 
-    // All remaining blocks in orphan_chain should all be valid now
-    // Compare the difficulty of the 2 forks (original and orphan)
-    const auto begin_index = fork_index + 1;
-
-    u256 main_work;
-    DEBUG_ONLY(auto result =) chain_.get_difficulty(main_work, begin_index);
-    BITCOIN_ASSERT(result);
-
-    delete_fork_chain_hash(orphan_chain[orphan_chain.size() - 1]->actual()->header.previous_block_hash);
-    if (orphan_work <= main_work)
-    {
-        if(orphan_chain.size() % node::locator_cap  == 0)
-            orphan_chain.back()->set_error(error::fetch_more_block);
-        add_fork_chain_hash(orphan_chain.back()->actual()->header.hash());
-
-        log::debug(LOG_BLOCKCHAIN)
-            << "Insufficient work to reorganize at [" << begin_index << "]" << "orphan_work:" << orphan_work << " main_work:" << main_work;
+    // All remaining blocks in orphan_chain should all be valid now, an
+    // invalid block may have clipped the chain below the main chain work.
+    if (insufficient_work(orphan_chain, begin_index, orphan_work, main_work))
         return;
-    }
 
     // Replace! Switch!
     block_detail::list released_blocks;
@@ -387,6 +433,23 @@ void organizer::replace_chain(uint64_t fork_index,
     notify_reorganize(fork_index, orphan_chain, released_blocks);
 }
 
+// Record the fork tip for more blocks if the fork does not win.
+bool organizer::insufficient_work(block_detail::list& orphan_chain,
+    uint64_t begin_index, const u256& orphan_work, const u256& main_work)
+{
+    delete_fork_chain_hash(orphan_chain.back()->actual()->header.previous_block_hash);
+    if (orphan_work > main_work)
+        return false;
+
+    if(orphan_chain.size() % node::locator_cap  == 0)
+        orphan_chain.back()->set_error(error::fetch_more_block);
+    add_fork_chain_hash(orphan_chain.back()->actual()->header.hash());
+
+    log::debug(LOG_BLOCKCHAIN)
+        << "Insufficient work to reorganize at [" << begin_index << "]" << "orphan_work:" << orphan_work << " main_work:" << main_work;
+    return true;
+}
+
 void organizer::remove_processed(block_detail::ptr remove_block)
 {
     const auto it = std::find(process_queue_.begin(), process_queue_.end(),
@@ -22,42 +22,66 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <utility>
 #include <metaverse/blockchain/block_detail.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
 
 orphan_pool::orphan_pool(size_t capacity)
+  : capacity_(capacity == 0 ? 1 : capacity),
+    sequence_(0)
 {
-    buffer_.reserve(capacity == 0 ? 1 : capacity);
+    entries_.reserve(capacity_);
 }
 
 // There is no validation whatsoever of the block up to this pont.
 bool orphan_pool::add(block_detail::ptr block)
 {
+    const auto hash = block->hash();
     const auto& header = block->actual()->header;
+    block_detail::ptr evicted;
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
     // No duplicates allowed.
-    if (exists(header))
+    if (exists(hash))
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return false;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.push_back(block);
+
+    // Make room by evicting the earliest arrival.
+    if (old_size >= capacity_)
+    {
+        evicted = arrivals_.begin()->second;
+        erase(entries_.find(evicted->hash()));
+    }
+
+    const auto sequence = sequence_++;
+    entries_.emplace(hash, entry{ block, sequence });
+    arrivals_.emplace(sequence, block);
+
+    if (!block->processed())
+        unprocessed_.emplace(sequence, block);
+
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
+    if (evicted)
+        log::debug(LOG_BLOCKCHAIN)
+            << "Orphan pool evicted block [" << encode_hash(evicted->hash())
+            << "] at capacity (" << capacity_ << ").";
+
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool added block [" << encode_hash(block->hash())
+        << "Orphan pool added block [" << encode_hash(hash)
         << "] previous [" << encode_hash(header.previous_block_hash)
         << "] old size (" << old_size << ").";
 
@@ -66,32 +90,33 @@ bool orphan_pool::add(block_detail::ptr block)
 
 void orphan_pool::remove(block_detail::ptr block)
 {
+    const auto hash = block->hash();
+
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
-    const auto it = std::find(buffer_.begin(), buffer_.end(), block);
+    const auto it = entries_.find(hash);
 
-    if (it == buffer_.end())
+    if (it == entries_.end() || it->second.block != block)
     {
         mutex_.unlock_upgrade();
         //-----------------------------------------------------------------
         return;
     }
 
-    const auto old_size = buffer_.size();
+    const auto old_size = entries_.size();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     mutex_.unlock_upgrade_and_lock();
-    buffer_.erase(it);
+    erase(it);
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
     log::debug(LOG_BLOCKCHAIN)
-        << "Orphan pool removed block [" << encode_hash(block->hash())
+        << "Orphan pool removed block [" << encode_hash(hash)
         << "] old size (" << old_size << ").";
 }
 
-// TODO: use hash table pool to eliminate this O(n^2) search.
 void orphan_pool::filter(message::get_data::ptr message) const
 {
     auto& inventories = message->inventories;
@@ -100,18 +125,19 @@ void orphan_pool::filter(message::get_data::ptr message) const
     // Critical Section
     shared_lock lock(mutex_);
 
-    for (auto it = inventories.begin(); it != inventories.end();)
-        if (it->is_block_type() && exists(it->hash))
-            it = inventories.erase(it);
-        else
-            ++it;
+    const auto orphan = [this](const message::inventory_vector& inventory)
+    {
+        return inventory.is_block_type() && exists(inventory.hash);
+    };
+
+    inventories.erase(std::remove_if(inventories.begin(), inventories.end(),
+        orphan), inventories.end());
     ///////////////////////////////////////////////////////////////////////////
 }
 
 block_detail::list orphan_pool::trace(block_detail::ptr end) const
 {
     block_detail::list trace;
-    trace.reserve(buffer_.size());
     trace.push_back(end);
     auto hash = end->actual()->header.previous_block_hash;
 
@@ -119,10 +145,11 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
     // Critical Section
     mutex_.lock_shared();
 
-    for (auto it = rfind(buffer_.rbegin(), hash); it != buffer_.rend(); it = rfind(it, hash))
+    for (auto it = entries_.find(hash); it != entries_.end();
+        it = entries_.find(hash))
     {
-        trace.push_back(*it);
-        hash = (*it)->actual()->header.previous_block_hash;
+        trace.push_back(it->second.block);
+        hash = it->second.block->actual()->header.previous_block_hash;
     }
 
     mutex_.unlock_shared();
@@ -130,54 +157,66 @@ block_detail::list orphan_pool::trace(block_detail::ptr end) const
 
     BITCOIN_ASSERT(!trace.empty());
     std::reverse(trace.begin(), trace.end());
-    trace.shrink_to_fit();
     return trace;
 }
 
 block_detail::list orphan_pool::unprocessed() const
 {
     block_detail::list unprocessed;
-    unprocessed.reserve(buffer_.size());
 
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    mutex_.lock_shared();
+    unique_lock lock(mutex_);
 
-    // Earlier blocks enter pool first, so reversal helps avoid fragmentation.
-    for (auto it = buffer_.rbegin(); it != buffer_.rend(); ++it)
-        if (!(*it)->processed())
-            unprocessed.push_back(*it);
+    // Blocks are only ever marked processed, so each is dropped once here.
+    for (auto it = unprocessed_.begin(); it != unprocessed_.end();)
+        if (it->second->processed())
+            it = unprocessed_.erase(it);
+        else
+            ++it;
 
-    mutex_.unlock_shared();
+    unprocessed.reserve(unprocessed_.size());
+
+    // Earlier blocks enter pool first, so reversal helps avoid fragmentation.
+    for (auto it = unprocessed_.rbegin(); it != unprocessed_.rend(); ++it)
+        unprocessed.push_back(it->second);
     ///////////////////////////////////////////////////////////////////////////
 
-    unprocessed.shrink_to_fit();
     return unprocessed;
 }
 
 bool orphan_pool::add_pending_block(const hash_digest& needed_block, const block_detail::ptr& pending_block)
 {
-    auto hash = pending_block->actual()->header.hash();
-    if(pending_blocks_hash_.find(hash) != pending_blocks_hash_.end()) 
-    {
+    const auto hash = pending_block->hash();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (!pending_blocks_hash_.insert(hash).second)
         return false;
-    }
 
-    pending_blocks_.insert(make_pair(needed_block, pending_block));
-    pending_blocks_hash_.insert(hash);
+    pending_blocks_.emplace(needed_block, pending_block);
     return true;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 block_detail::ptr orphan_pool::delete_pending_block(const hash_digest& needed_block)
 {
     block_detail::ptr ret;
-    auto it = pending_blocks_.find(needed_block);
-    if(it != pending_blocks_.end())
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = pending_blocks_.find(needed_block);
+    if (it != pending_blocks_.end())
     {
         ret = it->second;
-        pending_blocks_hash_.erase(it->second->actual()->header.hash());
+        pending_blocks_hash_.erase(ret->hash());
         pending_blocks_.erase(it);
     }
+    ///////////////////////////////////////////////////////////////////////////
 
     return ret;
 }
@@ -187,44 +226,17 @@ block_detail::ptr orphan_pool::delete_pending_block(const hash_digest& needed_bl
 
 bool orphan_pool::exists(const hash_digest& hash) const
 {
-    const auto match = [&hash](const block_detail::ptr& entry)
-    {
-        return hash == entry->hash();
-    };
-
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
+    return entries_.find(hash) != entries_.end();
 }
 
-bool orphan_pool::exists(const chain::header& header) const
+// The caller must hold the exclusive lock.
+void orphan_pool::erase(entries::iterator it)
 {
-    const auto match = [&header](const block_detail::ptr& entry)
-    {
-        return header == entry->actual()->header;
-    };
-
-    return std::any_of(buffer_.begin(), buffer_.end(), match);
-}
-
-/*
-orphan_pool::const_iterator orphan_pool::find(buffer::const_iterator begin, const hash_digest& hash) const
-{
-    const auto match = [&hash](const block_detail::ptr& entry)
-    {
-        return hash == entry->hash();
-    };
-
-    return std::find_if(begin, buffer_.end(), match);
-}
-*/
-
-orphan_pool::const_reverse_iterator orphan_pool::rfind(buffer::const_reverse_iterator begin, const hash_digest& hash) const
-{
-    const auto match = [&hash](const block_detail::ptr& entry)
-    {
-        return hash == entry->hash();
-    };
-
-    return std::find_if(begin, buffer_.rend(), match);
+    BITCOIN_ASSERT(it != entries_.end());
+    const auto sequence = it->second.sequence;
+    arrivals_.erase(sequence);
+    unprocessed_.erase(sequence);
+    entries_.erase(it);
 }
 
 } // namespace blockchain
@@ -0,0 +1,106 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/blockchain/script_cache.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace blockchain {
+
+using namespace chain;
+
+// Spread contention over independently locked shards.
+static constexpr size_t shard_count = 16;
+
+script_cache::script_cache(size_t capacity)
+  : shard_capacity_(std::max<size_t>(capacity / shard_count, 1)),
+    shards_(shard_count)
+{
+}
+
+script_cache::shard& script_cache::find_shard(const input_point& input)
+{
+    return shards_[std::hash<point>()(input) % shards_.size()];
+}
+
+void script_cache::store(const input_point& input, uint32_t flags)
+{
+    auto& shard = find_shard(input);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(shard.mutex);
+
+    const auto entry = shard.flags.emplace(input, flags);
+    if (!entry.second)
+    {
+        entry.first->second |= flags;
+        return;
+    }
+
+    // Drop the oldest entries, some may already have been taken.
+    shard.order.push_back(input);
+    while (shard.order.size() > shard_capacity_)
+    {
+        shard.flags.erase(shard.order.front());
+        shard.order.pop_front();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool script_cache::take(const input_point& input, uint32_t flags)
+{
+    auto& shard = find_shard(input);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(shard.mutex);
+
+    const auto entry = shard.flags.find(input);
+    if (entry == shard.flags.end() || (entry->second & flags) != flags)
+        return false;
+
+    shard.flags.erase(entry);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t script_cache::size() const
+{
+    size_t count = 0;
+
+    for (const auto& shard: shards_)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        shared_lock lock(shard.mutex);
+        count += shard.flags.size();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    return count;
+}
+
+} // namespace blockchain
+} // namespace libbitcoin
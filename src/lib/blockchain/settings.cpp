@@ -33,6 +33,9 @@ settings::settings()
   : block_pool_capacity(5000),
     transaction_pool_capacity(4096),
     transaction_pool_consistency(false),
+    transaction_pool_file("mempool.cache"),
+    transaction_pool_snapshot_minutes(10),
+    script_cache_capacity(100000),
     use_testnet_rules(false)
 {
 }
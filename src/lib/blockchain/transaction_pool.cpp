@@ -22,10 +22,14 @@
 
 #include <algorithm>
 #include <cstddef>
+#include <ctime>
+#include <iterator>
 #include <memory>
 #include <system_error>
 #include <metaverse/bitcoin.hpp>
+#include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/blockchain/block_chain.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
 #include <metaverse/blockchain/settings.hpp>
 #include <metaverse/blockchain/validate_transaction.hpp>
 
@@ -38,15 +42,31 @@ using namespace chain;
 using namespace wallet;
 using namespace std::placeholders;
 
+static metric_gauge& pool_size()
+{
+    static auto& size = metrics::gauge("mvs_txpool_transactions",
+        "Transactions in the memory pool.").get();
+    return size;
+}
+
+static uint32_t now()
+{
+    return static_cast<uint32_t>(std::time(nullptr));
+}
+
 transaction_pool::transaction_pool(threadpool& pool, block_chain& chain,
                                    const settings& settings)
     : stopped_(true),
       maintain_consistency_(settings.transaction_pool_consistency),
       buffer_(settings.transaction_pool_capacity),
+      pool_(pool),
       dispatch_(pool, NAME),
       blockchain_(chain),
       index_(pool, chain),
-      subscriber_(std::make_shared<transaction_subscriber>(pool, NAME))
+      subscriber_(std::make_shared<transaction_subscriber>(pool, NAME)),
+      file_path_(settings.transaction_pool_file.empty() ? boost::filesystem::path() :
+          default_data_path() / settings.transaction_pool_file),
+      snapshot_interval_(asio::minutes(settings.transaction_pool_snapshot_minutes))
 {
 }
 
@@ -65,15 +85,49 @@ void transaction_pool::start()
     blockchain_.subscribe_reorganize(
         std::bind(&transaction_pool::handle_reorganized,
                   this, _1, _2, _3, _4));
+
+    if (file_path_.empty())
+        return;
+
+    auto entries = std::make_shared<entry_list>();
+    auto same_tip = false;
+    bc::ifstream file(file_path_.string(), std::ios::binary);
+
+    if (file && load(file, *entries, same_tip) && !entries->empty())
+    {
+        log::info(LOG_BLOCKCHAIN)
+                << "Restoring " << entries->size() << " transactions from "
+                << file_path_.string()
+                << (same_tip ? "" : ", the chain tip changed, revalidating");
+
+        dispatch_.ordered(&transaction_pool::restore,
+                          this, entries, 0, same_tip);
+    }
+
+    if (snapshot_interval_ == asio::duration::zero())
+        return;
+
+    snapshot_timer_ = std::make_shared<deadline>(pool_, snapshot_interval_);
+    snapshot_timer_->start(
+        std::bind(&transaction_pool::handle_snapshot_timer, this, _1));
 }
 
 // The subscriber is not restartable.
+// This is called once the threadpool is joined (see p2p_node::close), so the
+// final snapshot is written directly rather than on the dispatch strand.
 void transaction_pool::stop()
 {
-    stopped_ = true;
+    const auto running = !stopped_.exchange(true);
+
+    if (snapshot_timer_)
+        snapshot_timer_->stop();
+
     index_.stop();
     subscriber_->stop();
     subscriber_->invoke(error::service_stopped, {}, {});
+
+    if (running)
+        save_snapshot();
 }
 
 void transaction_pool::fired()
@@ -261,6 +315,12 @@ code transaction_pool::check_symbol_repeat(transaction_ptr tx)
 // handle_confirm will never fire if handle_validate returns a failure code.
 void transaction_pool::store(transaction_ptr tx,
                              confirm_handler handle_confirm, validate_handler handle_validate)
+{
+    store(tx, now(), handle_confirm, handle_validate);
+}
+
+void transaction_pool::store(transaction_ptr tx, uint32_t arrival,
+                             confirm_handler handle_confirm, validate_handler handle_validate)
 {
     if (stopped())
     {
@@ -270,20 +330,28 @@ void transaction_pool::store(transaction_ptr tx,
 
     validate(tx,
              std::bind(&transaction_pool::do_store,
-                       this, _1, _2, _3, handle_confirm, handle_validate));
+                       this, _1, _2, _3, handle_confirm, handle_validate, arrival));
 }
 
 // This is overly complex due to the transaction pool and index split.
 void transaction_pool::do_store(const code& ec, transaction_ptr tx,
                                 const indexes& unconfirmed, confirm_handler handle_confirm,
-                                validate_handler handle_validate)
+                                validate_handler handle_validate, uint32_t arrival)
 {
+    static auto& accepted = metrics::counter("mvs_txpool_accepted_total",
+        "Transactions accepted into the memory pool.").get();
+    static auto& rejected = metrics::counter("mvs_txpool_rejected_total",
+        "Transactions rejected by the memory pool by reason.", "reason");
+
     if (ec)
     {
+        rejected.get(ec.message()).increment();
         handle_validate(ec, tx, {});
         return;
     }
 
+    accepted.increment();
+
     // Set up deindexing to run after transaction pool removal.
     const auto do_deindex = [this, handle_confirm](const code ec,
                             transaction_ptr tx)
@@ -298,7 +366,7 @@ void transaction_pool::do_store(const code& ec, transaction_ptr tx,
     };
 
     // Add to pool, save confirmation handler.
-    add(tx, do_deindex);
+    add(tx, unconfirmed, do_deindex, arrival);
 
     const auto handle_indexed = [this, handle_validate, tx, unconfirmed](
                                     const code ec)
@@ -328,7 +396,8 @@ void transaction_pool::fetch(fetch_all_handler handler)
     const auto tx_fetcher = [this, handler]()
     {
         std::vector<transaction_ptr> transactions;
-        for (auto item : buffer_)
+        transactions.reserve(buffer_.size());
+        for (const auto& item : buffer_)
         {
             if (item.tx)
                 transactions.push_back(item.tx);
@@ -495,17 +564,249 @@ void transaction_pool::notify_transaction(const point::indexes& unconfirmed,
     subscriber_->relay(error::success, unconfirmed, tx);
 }
 
+// Snapshot methods.
+// ----------------------------------------------------------------------------
+
+// The snapshot file is the magic, the format version, the chain tip it was
+// taken at and the entry count, then each entry in arrival order with its
+// arrival time, its fee, its unconfirmed input indexes and the transaction in
+// wire format, followed by a checksum of all of the above.
+static const std::string snapshot_magic("mvs.mempool");
+static constexpr uint32_t snapshot_version = 1;
+static constexpr uint32_t snapshot_tx_version = version::level::maximum;
+
+bool transaction_pool::get_tip(uint64_t& out_height,
+                               hash_digest& out_hash) const
+{
+    const auto& chain = static_cast<const block_chain_impl&>(blockchain_);
+
+    header tip;
+    if (!chain.get_last_height(out_height) || !chain.get_header(tip, out_height))
+        return false;
+
+    out_hash = tip.hash();
+    return true;
+}
+
+bool transaction_pool::load(std::istream& file, entry_list& out_entries,
+                            bool& out_same_tip) const
+{
+    const data_chunk data((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+
+    if (data.size() < snapshot_magic.size() + checksum_size ||
+        !std::equal(snapshot_magic.begin(), snapshot_magic.end(), data.begin()) ||
+        !verify_checksum(data))
+    {
+        log::warning(LOG_BLOCKCHAIN)
+                << "Ignoring invalid transaction pool snapshot.";
+        return false;
+    }
+
+    data_chunk body(data.begin() + snapshot_magic.size(),
+                    data.end() - checksum_size);
+    data_source stream(body);
+    istream_reader source(stream);
+
+    if (source.read_4_bytes_little_endian() != snapshot_version)
+        return false;
+
+    const auto height = source.read_8_bytes_little_endian();
+    const auto hash = source.read_hash();
+    const auto count = source.read_4_bytes_little_endian();
+
+    for (uint32_t index = 0; index < count && source; ++index)
+    {
+        entry item;
+        item.arrival = source.read_4_bytes_little_endian();
+        const auto fee = source.read_8_bytes_little_endian();
+
+        const auto inputs = source.read_4_bytes_little_endian();
+        for (uint32_t input = 0; input < inputs && source; ++input)
+            item.unconfirmed.push_back(source.read_4_bytes_little_endian());
+
+        item.tx = std::make_shared<message::transaction_message>();
+        if (!item.tx->from_data(snapshot_tx_version, source))
+            return false;
+
+        // The fee is set by validation, which a same tip restore skips.
+        item.tx->set_fee(fee);
+
+        out_entries.push_back(item);
+    }
+
+    if (!source)
+        return false;
+
+    uint64_t tip_height;
+    hash_digest tip_hash;
+    out_same_tip = get_tip(tip_height, tip_hash) && tip_height == height &&
+        tip_hash == hash;
+    return true;
+}
+
+void transaction_pool::save(std::ostream& file) const
+{
+    uint64_t height = 0;
+    auto hash = null_hash;
+    get_tip(height, hash);
+
+    data_chunk data;
+    data_sink stream(data);
+    stream.write(snapshot_magic.data(), snapshot_magic.size());
+
+    ostream_writer sink(stream);
+    sink.write_4_bytes_little_endian(snapshot_version);
+    sink.write_8_bytes_little_endian(height);
+    sink.write_hash(hash);
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(buffer_.size()));
+
+    for (const auto& entry: buffer_)
+    {
+        sink.write_4_bytes_little_endian(entry.arrival);
+        sink.write_8_bytes_little_endian(entry.tx->fee());
+        sink.write_4_bytes_little_endian(
+            static_cast<uint32_t>(entry.unconfirmed.size()));
+
+        for (const auto index: entry.unconfirmed)
+            sink.write_4_bytes_little_endian(index);
+
+        entry.tx->to_data(snapshot_tx_version, sink);
+    }
+
+    stream.flush();
+    append_checksum(data);
+    file.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+// This is not thread safe, call on the dispatch strand or once threads are
+// joined. The file is replaced by rename so a crash cannot leave a partial one.
+void transaction_pool::save_snapshot()
+{
+    if (file_path_.empty())
+        return;
+
+    const auto temporary = file_path_.string() + ".tmp";
+    {
+        bc::ofstream file(temporary, std::ios::binary);
+        if (!file.bad())
+            save(file);
+
+        if (!file)
+        {
+            log::error(LOG_BLOCKCHAIN)
+                    << "Failed to write transaction pool snapshot ("
+                    << temporary << ")";
+            return;
+        }
+    }
+
+    boost::system::error_code ec;
+    boost::filesystem::rename(temporary, file_path_, ec);
+
+    if (ec)
+    {
+        log::error(LOG_BLOCKCHAIN)
+                << "Failed to replace transaction pool snapshot ("
+                << file_path_.string() << "): " << ec.message();
+        return;
+    }
+
+    log::debug(LOG_BLOCKCHAIN)
+            << "Transaction pool saved (" << buffer_.size() << ") to "
+            << file_path_.string();
+}
+
+void transaction_pool::handle_snapshot_timer(const code& ec)
+{
+    if (ec || stopped())
+        return;
+
+    dispatch_.ordered(&transaction_pool::save_snapshot, this);
+    snapshot_timer_->start(
+        std::bind(&transaction_pool::handle_snapshot_timer, this, _1));
+}
+
+// Entries are admitted in arrival order so parents precede their children.
+// At the tip the snapshot was taken at an entry is admitted as validated then,
+// unless the pool has since changed under it. Otherwise it is revalidated.
+void transaction_pool::restore(std::shared_ptr<entry_list> entries,
+                               size_t position, bool same_tip)
+{
+    const auto handle_confirm = [](const code& ec, transaction_ptr tx)
+    {
+        log::debug(LOG_BLOCKCHAIN)
+                << "Restored transaction [" << encode_hash(tx->hash())
+                << "] left the pool: " << ec.message();
+    };
+
+    const auto handle_validate = [](const code&, transaction_ptr,
+                                    const indexes&)
+    {
+    };
+
+    for (; position < entries->size(); ++position)
+    {
+        if (stopped())
+            return;
+
+        const auto& item = (*entries)[position];
+        const auto& tx = item.tx;
+
+        if (is_in_pool(tx->hash()))
+            continue;
+
+        const auto parent_pooled = [this, &tx](uint32_t index)
+        {
+            return index < tx->inputs.size() &&
+                is_in_pool(tx->inputs[index].previous_output.hash);
+        };
+
+        if (same_tip && !is_spent_in_pool(tx) && !check_symbol_repeat(tx) &&
+            std::all_of(item.unconfirmed.begin(), item.unconfirmed.end(),
+                        parent_pooled))
+        {
+            do_store(error::success, tx, item.unconfirmed, handle_confirm,
+                     handle_validate, item.arrival);
+            continue;
+        }
+
+        // Continue with the next entry once this one is settled.
+        store(tx, item.arrival, handle_confirm,
+              std::bind(&transaction_pool::handle_restored,
+                        this, _1, _2, entries, position + 1, same_tip));
+        return;
+    }
+
+    log::info(LOG_BLOCKCHAIN)
+            << "Transaction pool restored (" << buffer_.size() << ")";
+}
+
+void transaction_pool::handle_restored(const code& ec, transaction_ptr tx,
+                                       std::shared_ptr<entry_list> entries, size_t position, bool same_tip)
+{
+    if (ec)
+        log::debug(LOG_BLOCKCHAIN)
+                << "Restored transaction [" << encode_hash(tx->hash())
+                << "] rejected: " << ec.message();
+
+    dispatch_.ordered(&transaction_pool::restore,
+                      this, entries, position, same_tip);
+}
+
 // Entry methods.
 // ----------------------------------------------------------------------------
 
 // A new transaction has been received, add it to the memory pool.
-void transaction_pool::add(transaction_ptr tx, confirm_handler handler)
+void transaction_pool::add(transaction_ptr tx, const indexes& unconfirmed,
+                           confirm_handler handler, uint32_t arrival)
 {
     // When a new tx is added to the buffer drop the oldest.
     if (maintain_consistency_ && buffer_.size() == buffer_.capacity())
         delete_package(error::pool_filled);
 
-    buffer_.push_back({ tx, handler });
+    buffer_.push_back({ tx, handler, unconfirmed, arrival });
+    pool_size().set(buffer_.size());
 }
 
 // There has been a reorg, clear the memory pool using the given reason code.
@@ -515,6 +816,7 @@ void transaction_pool::clear(const code& ec)
         entry.handle_confirm(ec, entry.tx);
 
     buffer_.clear();
+    pool_size().set(0);
 }
 
 // Delete memory pool txs that are obsoleted by a new block acceptance.
@@ -645,6 +947,7 @@ bool transaction_pool::delete_single(const hash_digest& tx_hash, const code& ec)
         buffer_.erase(it);
     }
 
+    pool_size().set(buffer_.size());
     return true;
 }
 
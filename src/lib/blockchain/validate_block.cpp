@@ -246,26 +246,9 @@ code validate_block::check_block(blockchain::block_chain_impl& chain) const
 
     RETURN_IF_STOPPED();
 
-    unsigned int coinbase_count = 0;
-    for (auto i : transactions) {
-        if (i.is_coinbase()) {
-            if (i.outputs.size() > 1 || i.outputs[0].is_etp() == false) {
-                return error::first_not_coinbase;
-            }
-            ++coinbase_count;
-        }
-    }
-    if (coinbase_count == 0) {
-        return error::first_not_coinbase;
-    }
-
-    for (auto it = transactions.begin() + coinbase_count; it != transactions.end(); ++it)
-    {
-        RETURN_IF_STOPPED();
-
-        if (it->is_coinbase())
-            return error::extra_coinbases;
-    }
+    const auto coinbases = check_coinbases(transactions, stop_callback_);
+    if (coinbases)
+        return coinbases;
 
     std::set<string> assets;
     std::set<string> asset_certs;
@@ -345,6 +328,34 @@ code validate_block::check_block(blockchain::block_chain_impl& chain) const
     return error::success;
 }
 
+// The leading transactions are coinbases, each paying a single etp output.
+code validate_block::check_coinbases(const transaction::list& txs,
+    const stopped_callback& stopped)
+{
+    size_t coinbase_count = 0;
+    for (const auto& tx: txs)
+    {
+        RETURN_IF_STOPPED();
+
+        if (tx.is_coinbase())
+        {
+            if (tx.outputs.size() > 1 || !tx.outputs[0].is_etp())
+                return error::first_not_coinbase;
+
+            ++coinbase_count;
+        }
+    }
+
+    if (coinbase_count == 0)
+        return error::first_not_coinbase;
+
+    for (auto it = txs.begin() + coinbase_count; it != txs.end(); ++it)
+        if (it->is_coinbase())
+            return error::extra_coinbases;
+
+    return error::success;
+}
+
 bool validate_block::is_distinct_tx_set(const transaction::list& txs)
 {
     // We define distinctness by transaction hash.
@@ -359,7 +370,7 @@ bool validate_block::is_distinct_tx_set(const transaction::list& txs)
     auto distinct_end = std::unique(hashes.begin(), hashes.end());
 #ifdef MVS_DEBUG
     if (distinct_end != hashes.end()) {
-        for (auto item : txs)
+        for (const auto& item : txs)
             log::warning(LOG_BLOCKCHAIN) << "hash:" << encode_hash(item.hash()) << " data:" << item.to_string(1);
     }
 #endif
@@ -651,9 +662,12 @@ bool validate_block::validate_inputs(const transaction& tx,
 {
     BITCOIN_ASSERT(!tx.is_coinbase());
 
+    // Parse the transaction once for the script checks of all inputs.
+    const consensus_context context(tx);
+
     ////////////// TODO: parallelize. //////////////
     for (size_t input_index = 0; input_index < tx.inputs.size(); ++input_index)
-        if (!connect_input(index_in_parent, tx, input_index, value_in,
+        if (!connect_input(index_in_parent, context, input_index, value_in,
                            total_sigops))
         {
             log::warning(LOG_BLOCKCHAIN) << "Invalid input ["
@@ -690,9 +704,10 @@ bool validate_block::script_hash_signature_operations_count(size_t& out_count,
 }
 
 bool validate_block::connect_input(size_t index_in_parent,
-                                   const transaction& current_tx, size_t input_index, uint64_t& value_in,
+                                   const consensus_context& context, size_t input_index, uint64_t& value_in,
                                    size_t& total_sigops) const
 {
+    const auto& current_tx = context.transaction();
     BITCOIN_ASSERT(input_index < current_tx.inputs.size());
 
     // Lookup previous output
@@ -749,8 +764,11 @@ bool validate_block::connect_input(size_t index_in_parent,
         }
     }
 
-    if (!validate_transaction::check_consensus(previous_tx_out.script,
-            current_tx, input_index, activations_))
+    // Scripts verified by the pool under the same rules are not rerun.
+    if (!is_script_verified({ current_tx.hash(), static_cast<uint32_t>(input_index) },
+            activations_) &&
+        !validate_transaction::check_consensus(previous_tx_out.script,
+            context, input_index, activations_))
     {
         log::warning(LOG_BLOCKCHAIN) << "Input script invalid consensus.";
         return false;
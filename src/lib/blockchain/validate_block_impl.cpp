@@ -145,6 +145,13 @@ bool validate_block_impl::transaction_exists(const hash_digest& tx_hash) const
     return tx_height <= fork_index_;
 }
 
+bool validate_block_impl::is_script_verified(const chain::input_point& input,
+    uint32_t flags) const
+{
+    return static_cast<block_chain_impl&>(chain_).verified_scripts().take(
+        input, flags);
+}
+
 bool validate_block_impl::is_output_spent(
     const chain::output_point& outpoint) const
 {
@@ -29,9 +29,7 @@
 #include <metaverse/blockchain/transaction_pool.hpp>
 #include <metaverse/consensus/miner.hpp>
 
-#ifdef WITH_CONSENSUS
-#include <metaverse/consensus.hpp>
-#endif
+#include <metaverse/blockchain/consensus_context.hpp>
 
 namespace libbitcoin {
 namespace blockchain {
@@ -51,7 +49,8 @@ validate_transaction::validate_transaction(block_chain& chain,
       tx_(tx),
       pool_(pool),
       dispatch_(dispatch),
-      tx_hash_(tx->hash())
+      tx_hash_(tx->hash()),
+      context_(*tx_)
 {
 }
 
@@ -231,7 +230,7 @@ void validate_transaction::handle_previous_tx(const code& ec,
     ///////////////////////////////////////////////////////////////////////////
 
     // Should check if inputs are standard here...
-    if (!connect_input(*tx_, current_input_, previous_tx, parent_height,
+    if (!connect_input(*tx_, context_, current_input_, previous_tx, parent_height,
                        last_block_height_, value_in_, script_context::all_enabled,
                        asset_amount_in_, asset_certs_in_,
                        old_symbol_in_, new_symbol_in_, business_kind_in_))
@@ -242,6 +241,11 @@ void validate_transaction::handle_previous_tx(const code& ec,
         return;
     }
 
+    // Spare block validation from verifying this script again.
+    static_cast<block_chain_impl&>(blockchain_).verified_scripts().store(
+        { tx_hash_, static_cast<uint32_t>(current_input_) },
+        script_context::all_enabled);
+
     // Search for double spends...
     blockchain_.fetch_spend(tx_->inputs[current_input_].previous_output,
                             dispatch_.unordered_delegate(&validate_transaction::check_double_spend,
@@ -279,6 +283,9 @@ void validate_transaction::check_fees()
         return;
     }
 
+    // Retained for fee filtering of relay announcements.
+    tx_->set_fee(fee);
+
     auto is_asset_type = (business_kind_in_ == business_kind::asset_issue)
                          || (business_kind_in_ == business_kind::asset_transfer);
     if (is_asset_type) {
@@ -465,7 +472,7 @@ code validate_transaction::check_secondaryissue_transaction(
             log::debug(LOG_BLOCKCHAIN) << "secondaryissue: invalid input: " << encode_hash(input.previous_output.hash);
             return error::input_not_found;
         }
-        auto prev_output = prev_tx.outputs.at(input.previous_output.index);
+        const auto& prev_output = prev_tx.outputs.at(input.previous_output.index);
         if (prev_output.is_asset() || prev_output.is_asset_cert()) {
             auto&& asset_address_in = prev_output.get_script_address();
             if (prev_output.is_asset_cert()) {
@@ -809,7 +816,7 @@ code validate_transaction::check_asset_mit_register_transaction(
         if (!chain.get_transaction(prev_tx, prev_height, input.previous_output.hash)) {
             return error::input_not_found;
         }
-        auto prev_output = prev_tx.outputs.at(input.previous_output.index);
+        const auto& prev_output = prev_tx.outputs.at(input.previous_output.index);
         if (prev_output.is_etp()) {
             auto&& asset_address_in = prev_output.get_script_address();
             if (asset_address != asset_address_in) {
@@ -931,7 +938,7 @@ bool validate_transaction::connect_did_input(
             return false;
         }
 
-        auto prev_output = prev_tx.outputs.at(input.previous_output.index);
+        const auto& prev_output = prev_tx.outputs.at(input.previous_output.index);
 
         if (prev_output.is_did_register() || prev_output.is_did_transfer()) {
             if (info.get_status() ==  DID_TRANSFERABLE_TYPE) {
@@ -972,7 +979,7 @@ bool validate_transaction::connect_input_address_match_did(
             return false;
         }
 
-        auto prev_output = prev_tx.outputs.at(input.previous_output.index);
+        const auto& prev_output = prev_tx.outputs.at(input.previous_output.index);
         auto address = prev_output.get_script_address();
         if (attach.get_from_did() == chain.get_did_from_address(address)) {
             return true;
@@ -1150,55 +1157,26 @@ code validate_transaction::check_transaction_basic(const transaction& tx, blockc
 bool validate_transaction::check_consensus(const script& prevout_script,
         const transaction& current_tx, size_t input_index, uint32_t flags)
 {
-    BITCOIN_ASSERT(input_index <= max_uint32);
-    BITCOIN_ASSERT(input_index < current_tx.inputs.size());
-    const auto input_index32 = static_cast<uint32_t>(input_index);
-
-#ifdef WITH_CONSENSUS
-    using namespace bc::consensus;
-    const auto previous_output_script = prevout_script.to_data(false);
-    data_chunk current_transaction = current_tx.to_data();
-
-    // Convert native flags to libbitcoin-consensus flags.
-    uint32_t consensus_flags = verify_flags_none;
-
-    if ((flags & script_context::bip16_enabled) != 0)
-        consensus_flags |= verify_flags_p2sh;
-
-    if ((flags & script_context::bip65_enabled) != 0)
-        consensus_flags |= verify_flags_checklocktimeverify;
-
-    if ((flags & script_context::bip66_enabled) != 0)
-        consensus_flags |= verify_flags_dersig;
-
-    if ((flags & script_context::attenuation_enabled) != 0)
-        consensus_flags |= verify_flags_checkattenuationverify;
-
-    const auto result = verify_script(current_transaction.data(),
-                                      current_transaction.size(), previous_output_script.data(),
-                                      previous_output_script.size(), input_index32, consensus_flags);
-
-    const auto valid = (result == verify_result::verify_result_eval_true);
-#else
-    // Copy the const prevout script so it can be run.
-    auto previous_output_script = prevout_script;
-    const auto& current_input_script = current_tx.inputs[input_index].script;
+    const consensus_context context(current_tx);
+    return check_consensus(prevout_script, context, input_index, flags);
+}
 
-    const auto valid = script::verify(current_input_script,
-                                      previous_output_script, current_tx, input_index32, flags);
-#endif
+bool validate_transaction::check_consensus(const script& prevout_script,
+        const consensus_context& context, size_t input_index, uint32_t flags)
+{
+    const auto valid = context.verify(prevout_script, input_index, flags);
 
     if (!valid) {
         log::warning(LOG_BLOCKCHAIN)
                 << "Invalid transaction ["
-                << encode_hash(current_tx.hash()) << "]";
+                << encode_hash(context.transaction().hash()) << "]";
     }
 
     return valid;
 }
 
 bool validate_transaction::connect_input(const transaction& tx,
-        size_t current_input, const transaction& previous_tx,
+        const consensus_context& context, size_t current_input, const transaction& previous_tx,
         size_t parent_height, size_t last_block_height, uint64_t& value_in,
         uint32_t flags, uint64_t& asset_amount_in,
         std::vector<asset_cert_type>& asset_certs_in,
@@ -1319,7 +1297,7 @@ bool validate_transaction::connect_input(const transaction& tx,
         }
     }
 
-    if (!check_consensus(previous_output.script, tx, current_input, flags)) {
+    if (!check_consensus(previous_output.script, context, current_input, flags)) {
         log::debug(LOG_BLOCKCHAIN) << "check_consensus failed";
         return false;
     }
@@ -1361,7 +1339,7 @@ bool validate_transaction::check_asset_symbol(const transaction& tx)
     // check asset symbol in out
     std::string old_symbol = "";
     std::string new_symbol = "";
-    for (auto elem : tx.outputs) {
+    for (const auto& elem : tx.outputs) {
         new_symbol = elem.get_asset_symbol();
         if (!new_symbol.empty()) {
             if (old_symbol.empty()) {
@@ -1461,7 +1439,7 @@ bool validate_transaction::check_did_symbol_match(const transaction& tx)
     // check did symbol in out
     std::string old_symbol = "";
     std::string new_symbol = "";
-    for (auto elem : tx.outputs) {
+    for (const auto& elem : tx.outputs) {
         new_symbol = elem.get_did_symbol();
         if (!new_symbol.empty()) {
             if (old_symbol.empty()) {
@@ -147,8 +147,34 @@ bool MinerAux::verifySeal(libbitcoin::chain::header& _header, libbitcoin::chain:
 	return false;
 }
 
+bool MinerAux::verify(libbitcoin::chain::header& _header, h256 const& _boundary)
+{
+	std::vector<libbitcoin::chain::header> headers{ _header };
+	std::vector<h256> values;
+	verify(headers, values);
+	return values.front() <= _boundary;
+}
 
+void MinerAux::verify(std::vector<libbitcoin::chain::header>& _headers, std::vector<h256>& _values)
+{
+	_values.assign(_headers.size(), ~h256());
+	if (_headers.empty())
+		return;
 
+	// The dag (or light cache) is looked up once for the whole batch.
+	h256 seedHash = HeaderAux::seedHash(_headers.front());
+	FullType dag;
+	DEV_GUARDED(get()->x_fulls)
+	dag = get()->m_fulls[seedHash].lock();
+	LightType light = dag ? nullptr : get()->get_light(seedHash);
 
-
-
+	for (size_t i = 0; i < _headers.size(); ++i)
+	{
+		auto& header = _headers[i];
+		h256 headerHash = HeaderAux::hashHead(header);
+		Nonce nonce = (Nonce)header.nonce;
+		Result result = dag ? dag->compute(headerHash, nonce) : light->compute(headerHash, nonce);
+		if (result.mixHash == (h256)header.mixhash)
+			_values[i] = result.value;
+	}
+}
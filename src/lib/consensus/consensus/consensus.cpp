@@ -24,10 +24,12 @@
 #include <cstddef>
 #include <iostream>
 #include <stdexcept>
+#include <vector>
 #include <string.h>
 #include <metaverse/consensus/define.hpp>
 #include <metaverse/consensus/export.hpp>
 #include <metaverse/consensus/version.hpp>
+#include "hash.h"
 #include "primitives/transaction.h"
 #include "pubkey.h"
 #include "script/interpreter.h"
@@ -179,6 +181,250 @@ unsigned int verify_flags_to_script_flags(unsigned int flags)
     return script_flags;
 }
 
+// Appends serialized objects to a byte vector.
+class VectorWriter
+{
+public:
+    VectorWriter(std::vector<unsigned char>& data, int nTypeIn, int nVersionIn)
+      : nType(nTypeIn), nVersion(nVersionIn), data_(data)
+    {
+    }
+
+    VectorWriter& write(const char* source, size_t size)
+    {
+        data_.insert(data_.end(), source, source + size);
+        return *this;
+    }
+
+    template <typename Object>
+    VectorWriter& operator<<(const Object& object)
+    {
+        ::Serialize(*this, object, nType, nVersion);
+        return *this;
+    }
+
+    int nType;
+    int nVersion;
+
+private:
+    std::vector<unsigned char>& data_;
+};
+
+// The signature hash serialization, as SignatureHash, is fixed apart from
+// the script code of the signed input when the hash type commits to all
+// inputs and outputs. For that case the parts around the signed input are
+// serialized once and the hash state of each input prefix is kept, so each
+// signature hash only writes the signed input and the cached suffix.
+class transaction_context::implementation
+{
+public:
+    implementation(const unsigned char* transaction, size_t transaction_size)
+      : size_(transaction_size), result_(verify_result_eval_true)
+    {
+        try
+        {
+            TxInputStream stream(transaction, transaction_size);
+            Unserialize(stream, tx_, SER_NETWORK, PROTOCOL_VERSION);
+        }
+        catch (const std::exception&)
+        {
+            result_ = verify_result_tx_invalid;
+            return;
+        }
+
+        if (tx_.GetSerializeSize(SER_NETWORK, PROTOCOL_VERSION) != size_)
+        {
+            result_ = verify_result_tx_size_invalid;
+            return;
+        }
+
+        static const CScriptBase blank;
+        VectorWriter inputs(inputs_, SER_GETHASH, 0);
+        VectorWriter outputs(outputs_, SER_GETHASH, 0);
+
+        CHashWriter prefix(SER_GETHASH, 0);
+        prefix << tx_.nVersion;
+        WriteCompactSize(prefix, tx_.vin.size());
+
+        prefixes_.reserve(tx_.vin.size());
+        offsets_.reserve(tx_.vin.size() + 1);
+
+        for (const auto& input: tx_.vin)
+        {
+            prefixes_.push_back(prefix);
+            offsets_.push_back(inputs_.size());
+
+            const auto start = inputs_.size();
+            inputs << input.prevout << blank << input.nSequence;
+            prefix.write(reinterpret_cast<const char*>(&inputs_[start]),
+                inputs_.size() - start);
+        }
+
+        offsets_.push_back(inputs_.size());
+
+        WriteCompactSize(outputs, tx_.vout.size());
+        for (const auto& output: tx_.vout)
+            outputs << output;
+
+        outputs << tx_.nLockTime;
+    }
+
+    class checker;
+
+    uint256 signature_hash(const CScript& script_code, unsigned int index,
+        int hash_type) const
+    {
+        const auto base_type = hash_type & 0x1f;
+        const auto cached = (hash_type & SIGHASH_ANYONECANPAY) == 0 &&
+            base_type != SIGHASH_SINGLE && base_type != SIGHASH_NONE;
+
+        if (!cached || index >= tx_.vin.size())
+            return SignatureHash(script_code, tx_, index, hash_type);
+
+        const auto& input = tx_.vin[index];
+        auto hash = prefixes_[index];
+        hash << input.prevout;
+        write_script_code(hash, script_code);
+        hash << input.nSequence;
+
+        const auto next = offsets_[index + 1];
+        hash.write(reinterpret_cast<const char*>(inputs_.data() + next),
+            inputs_.size() - next);
+        hash.write(reinterpret_cast<const char*>(outputs_.data()),
+            outputs_.size());
+        hash << hash_type;
+        return hash.GetHash();
+    }
+
+    const CTransaction& tx() const
+    {
+        return tx_;
+    }
+
+    verify_result_type result() const
+    {
+        return result_;
+    }
+
+private:
+    // As CTransactionSignatureSerializer::SerializeScriptCode.
+    static void write_script_code(CHashWriter& hash, const CScript& script)
+    {
+        auto it = script.begin();
+        auto begin = it;
+        opcodetype opcode;
+        unsigned int separators = 0;
+
+        while (script.GetOp(it, opcode))
+            if (opcode == OP_CODESEPARATOR)
+                separators++;
+
+        WriteCompactSize(hash, script.size() - separators);
+        it = begin;
+
+        while (script.GetOp(it, opcode))
+        {
+            if (opcode == OP_CODESEPARATOR)
+            {
+                hash.write((char*)&begin[0], it - begin - 1);
+                begin = it;
+            }
+        }
+
+        if (begin != script.end())
+            hash.write((char*)&begin[0], it - begin);
+    }
+
+    CTransaction tx_;
+    const size_t size_;
+    verify_result_type result_;
+
+    // Hash state after the version, input count and blanked inputs before
+    // each input.
+    std::vector<CHashWriter> prefixes_;
+
+    // The blanked inputs and their offsets, followed by the end offset.
+    std::vector<unsigned char> inputs_;
+    std::vector<size_t> offsets_;
+
+    // The output count, outputs and lock time.
+    std::vector<unsigned char> outputs_;
+};
+
+// Signature checker computing signature hashes from the context.
+class transaction_context::implementation::checker
+  : public TransactionSignatureChecker
+{
+public:
+    checker(const implementation& context, unsigned int index)
+      : TransactionSignatureChecker(&context.tx(), index),
+        context_(context), index_(index)
+    {
+    }
+
+    bool CheckSig(const std::vector<unsigned char>& vchSigIn,
+        const std::vector<unsigned char>& vchPubKey,
+        const CScript& scriptCode) const override
+    {
+        CPubKey pubkey(vchPubKey);
+        if (!pubkey.IsValid())
+            return false;
+
+        // Hash type is one byte tacked on to the end of the signature.
+        std::vector<unsigned char> vchSig(vchSigIn);
+        if (vchSig.empty())
+            return false;
+
+        const int hash_type = vchSig.back();
+        vchSig.pop_back();
+
+        const auto sighash = context_.signature_hash(scriptCode, index_,
+            hash_type);
+        return VerifySignature(vchSig, pubkey, sighash);
+    }
+
+private:
+    const implementation& context_;
+    const unsigned int index_;
+};
+
+transaction_context::transaction_context(const unsigned char* transaction,
+    size_t transaction_size)
+{
+    if (transaction_size > 0 && transaction == NULL)
+        throw std::invalid_argument("transaction");
+
+    implementation_.reset(new implementation(transaction, transaction_size));
+}
+
+transaction_context::~transaction_context()
+{
+}
+
+verify_result_type transaction_context::verify_script(
+    const unsigned char* prevout_script, size_t prevout_script_size,
+    unsigned int tx_input_index, unsigned int flags) const
+{
+    if (prevout_script_size > 0 && prevout_script == NULL)
+        throw std::invalid_argument("prevout_script");
+
+    if (implementation_->result() != verify_result_eval_true)
+        return implementation_->result();
+
+    const auto& tx = implementation_->tx();
+    if (tx_input_index >= tx.vin.size())
+        return verify_result_tx_input_invalid;
+
+    ScriptError_t error;
+    implementation::checker checker(*implementation_, tx_input_index);
+    const unsigned int script_flags = verify_flags_to_script_flags(flags);
+    CScript output_script(prevout_script, prevout_script + prevout_script_size);
+    const CScript& input_script = tx.vin[tx_input_index].scriptSig;
+
+    VerifyScript(input_script, output_script, script_flags, checker, &error);
+    return script_error_to_verify_result(error);
+}
+
 // This function is published. The implementation exposes no satoshi internals.
 verify_result_type verify_script(const unsigned char* transaction, 
     size_t transaction_size, const unsigned char* prevout_script, 
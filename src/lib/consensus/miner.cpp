@@ -25,6 +25,7 @@
 
 #include <algorithm>
 #include <functional>
+#include <set>
 #include <system_error>
 #include <boost/thread.hpp>
 #include <metaverse/consensus/miner/MinerAux.h>
@@ -70,6 +71,7 @@ miner::miner(p2p_node& node)
     , new_block_number_(0)
     , new_block_limit_(0)
     , setting_(node_.chain_impl().chain_settings())
+    , template_subscribed_(false)
 {
     if (setting_.use_testnet_rules) {
         bc::HeaderAux::set_as_testnet();
@@ -81,49 +83,111 @@ miner::~miner()
     stop();
 }
 
-bool miner::get_input_etp(const transaction& tx, const std::vector<transaction_ptr>& transactions,
-    uint64_t& total_inputs, previous_out_map_t& previous_out_map) const
+miner::template_entry_ptr miner::prepare_template_entry(transaction_ptr tx,
+    const transaction_map_t& pool_txs, bool& invalid) const
 {
-    total_inputs = 0;
+    invalid = false;
     block_chain_impl& block_chain = node_.chain_impl();
-    for (auto& input : tx.inputs) {
+
+    for (const auto& output : tx->outputs) {
+        if (tx->version >= transaction_version::check_output_script
+            && output.script.pattern() == script_pattern::non_standard) {
+#ifdef MVS_DEBUG
+            log::error(LOG_HEADER) << "transaction output script error! tx:" << tx->to_string(1);
+#endif
+            invalid = true;
+            return nullptr;
+        }
+    }
+
+    auto entry = std::make_shared<template_entry>();
+    entry->tx = tx;
+    entry->serialized_size = tx->serialized_size(0);
+    entry->sigops = blockchain::validate_block::legacy_sigops_count(*tx);
+    entry->confirmed_value = 0;
+    entry->confirmed_value_height = 0;
+
+    uint64_t total_input_value = 0;
+    for (const auto& input : tx->inputs) {
+        const auto& point = input.previous_output;
+        const chain::output* prev_output = nullptr;
+
         transaction prev_tx;
         uint64_t prev_height = 0;
-        uint64_t input_value = 0;
-        if (block_chain.get_transaction(prev_tx, prev_height, input.previous_output.hash)) {
-            input_value = prev_tx.outputs[input.previous_output.index].value;
-            previous_out_map[input.previous_output] =
-                std::make_pair(prev_height, prev_tx.outputs[input.previous_output.index]);
+        if (block_chain.get_transaction(prev_tx, prev_height, point.hash)) {
+            if (point.index >= prev_tx.outputs.size()) {
+                invalid = true;
+                return nullptr;
+            }
+
+            prev_output = &prev_tx.outputs[point.index];
+            entry->confirmed_value += prev_output->value;
+            entry->confirmed_value_height += (double)prev_output->value * prev_height;
         }
         else {
-            const hash_digest& hash = input.previous_output.hash;
-            const auto found = [&hash](const transaction_ptr & entry)
-            {
-                return entry->hash() == hash;
-            };
-            auto it = std::find_if(transactions.begin(), transactions.end(), found);
-            if (it != transactions.end()) {
-                input_value = (*it)->outputs[input.previous_output.index].value;
-                previous_out_map[input.previous_output] =
-                    std::make_pair(max_uint64, (*it)->outputs[input.previous_output.index]);
-            }
-            else {
+            auto it = pool_txs.find(point.hash);
+            if (it == pool_txs.end()) {
 #ifdef MVS_DEBUG
-                log::debug(LOG_HEADER) << "previous transaction not ready: " << encode_hash(hash);
+                log::debug(LOG_HEADER) << "previous transaction not ready: " << encode_hash(point.hash);
 #endif
-                return false;
+                // skip tx but not delete it from pool if parent tx is not ready
+                return nullptr;
             }
+
+            if (point.index >= it->second->outputs.size()) {
+                invalid = true;
+                return nullptr;
+            }
+
+            prev_output = &it->second->outputs[point.index];
+            entry->parents.push_back(point.hash);
         }
 
-        total_inputs += input_value;
+        total_input_value += prev_output->value;
+
+        size_t count = 0;
+        if (blockchain::validate_block::script_hash_signature_operations_count(
+                count, prev_output->script, input.script)) {
+            entry->sigops += count;
+        }
     }
 
-    return true;
+    // check normal fee
+    const uint64_t total_output_value = tx->total_output_value();
+    if (total_input_value < total_output_value + min_tx_fee) {
+        invalid = true;
+    }
+    else {
+        entry->fee = total_input_value - total_output_value;
+        for (const auto& output : tx->outputs) {
+            // check fee for issue asset
+            if (output.is_asset_issue() && entry->fee < coin_price(10)) {
+                invalid = true;
+                break;
+            }
+            // check fee for issue did
+            else if (output.is_did_register() && entry->fee < coin_price(1)) {
+                invalid = true;
+                break;
+            }
+        }
+    }
+
+    if (invalid) {
+#ifdef MVS_DEBUG
+        log::debug(LOG_HEADER) << "not enough fee! input: "
+                               << total_input_value << ", output: " << total_output_value
+                               << ", tx: " << tx->to_string(1);
+#endif
+        return nullptr;
+    }
+
+    return entry;
 }
 
-bool miner::get_transaction(std::vector<transaction_ptr>& transactions,
-    previous_out_map_t& previous_out_map, tx_fee_map_t& tx_fee_map) const
+void miner::get_template_entries(std::vector<template_entry_ptr>& entries)
 {
+    std::vector<transaction_ptr> transactions;
     boost::mutex mutex;
     mutex.lock();
     auto f = [&transactions, &mutex](const error_code & code, const vector<transaction_ptr>& transactions_) -> void
@@ -135,75 +199,129 @@ bool miner::get_transaction(std::vector<transaction_ptr>& transactions,
 
     boost::unique_lock<boost::mutex> lock(mutex);
 
-    if (transactions.empty() == false) {
-        set<hash_digest> sets;
-        for (auto i = transactions.begin(); i != transactions.end(); ) {
-            auto& tx = **i;
-            auto hash = tx.hash();
-            auto transaction_is_ok = true;
+    transaction_map_t pool_txs;
+    for (const auto& tx : transactions) {
+        pool_txs.emplace(tx->hash(), tx);
+    }
 
-            uint64_t fee = 0;
+    std::lock_guard<std::mutex> guard(template_mutex_);
 
-            for (auto& output : tx.outputs) {
-                if (tx.version >= transaction_version::check_output_script
-                    && output.script.pattern() == script_pattern::non_standard) {
-#ifdef MVS_DEBUG
-                    log::error(LOG_HEADER) << "transaction output script error! tx:" << tx.to_string(1);
-#endif
-                    node_.pool().delete_tx(hash);
-                    transaction_is_ok = false;
-                    break;
-                }
+    // Only entries of txs still in the pool survive into the new cache.
+    template_cache_t cache;
+    for (const auto& tx : transactions) {
+        const auto hash = tx->hash();
+        if (cache.find(hash) != cache.end()) {
+            continue;
+        }
 
-                uint64_t total_input_value = 0;
-                bool ready = get_input_etp(tx, transactions, total_input_value, previous_out_map);
-                if (!ready) {
-                    // erase tx but not delete it from pool if parent tx is not ready
-                    transaction_is_ok = false;
-                    break;
-                }
+        template_entry_ptr entry;
+        auto it = template_cache_.find(hash);
+        if (it != template_cache_.end()) {
+            entry = it->second;
+        }
+        else {
+            bool invalid = false;
+            entry = prepare_template_entry(tx, pool_txs, invalid);
+            if (invalid) {
+                // delete from pool if never minable
+                node_.pool().delete_tx(hash);
+            }
+        }
+
+        if (entry) {
+            cache.emplace(hash, entry);
+            entries.push_back(entry);
+        }
+    }
 
-                uint64_t total_output_value = tx.total_output_value();
+    template_cache_.swap(cache);
+}
 
-                // check normal fee
-                if (total_input_value < total_output_value + min_tx_fee) {
-                    transaction_is_ok = false;
-                }
-                else {
-                    fee = total_input_value - total_output_value;
-                    // check fee for issue asset
-                    if (output.is_asset_issue() && fee < coin_price(10)) {
-                        transaction_is_ok = false;
-                    }
-                    // check fee for issue did
-                    else if (output.is_did_register() && fee < coin_price(1)) {
-                        transaction_is_ok = false;
-                    }
-                }
+void miner::subscribe_template_updates()
+{
+    if (template_subscribed_.exchange(true)) {
+        return;
+    }
 
-                if (!transaction_is_ok) {
-#ifdef MVS_DEBUG
-                    log::debug(LOG_HEADER) << "not enough fee! input: "
-                                           << total_input_value << ", output: " << total_output_value
-                                           << ", tx: " << tx.to_string(1);
-#endif
-                    // delete ifrom pool if not enough fee
-                    node_.pool().delete_tx(hash);
-                    break;
-                }
-            }
+    node_.subscribe_transaction_pool(
+        std::bind(&miner::handle_pool_transaction,
+            this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
 
-            if (transaction_is_ok && (sets.find(hash) == sets.end())) {
-                tx_fee_map[hash] = fee;
-                sets.insert(hash);
-                ++i;
-            }
-            else {
-                i = transactions.erase(i);
-            }
+    node_.subscribe_blockchain(
+        std::bind(&miner::handle_reorganized,
+            this, std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4));
+}
+
+bool miner::handle_pool_transaction(const code& ec, const index_list&, transaction_ptr tx)
+{
+    if (ec == (code)error::service_stopped) {
+        template_subscribed_ = false;
+        return false;
+    }
+
+    if (ec || !tx) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> guard(template_mutex_);
+
+    // Pool parents are resolved against already prepared entries only,
+    // anything else is prepared on the next template build.
+    transaction_map_t parents;
+    for (const auto& input : tx->inputs) {
+        auto it = template_cache_.find(input.previous_output.hash);
+        if (it != template_cache_.end()) {
+            parents.emplace(it->first, it->second->tx);
+        }
+    }
+
+    bool invalid = false;
+    auto entry = prepare_template_entry(tx, parents, invalid);
+    if (entry) {
+        template_cache_[tx->hash()] = entry;
+    }
+
+    return true;
+}
+
+bool miner::handle_reorganized(const code& ec, size_t fork_point,
+    const block_list& new_blocks, const block_list& replaced_blocks)
+{
+    if (ec == (code)error::service_stopped) {
+        template_subscribed_ = false;
+        return false;
+    }
+
+    if (ec) {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> guard(template_mutex_);
+
+    // The pool is cleared on reorganization, so is the template.
+    if (!replaced_blocks.empty()) {
+        template_cache_.clear();
+        return true;
+    }
+
+    for (const auto& block : new_blocks) {
+        for (const auto& tx : block->transactions) {
+            template_cache_.erase(tx.hash());
+        }
+    }
+
+    // Parents may have been confirmed, which changes priority and packages.
+    for (auto it = template_cache_.begin(); it != template_cache_.end(); ) {
+        if (it->second->parents.empty()) {
+            ++it;
+        }
+        else {
+            it = template_cache_.erase(it);
         }
     }
-    return transactions.empty() == false;
+
+    return true;
 }
 
 bool miner::script_hash_signature_operations_count(size_t &count, const chain::input& input, vector<transaction_ptr>& transactions)
@@ -359,24 +477,21 @@ uint64_t miner::calculate_lockblock_reward(uint64_t lcok_heights, uint64_t num)
 }
 
 struct transaction_dependent {
-    std::shared_ptr<hash_digest> hash;
+    std::vector<hash_digest> children;
     unsigned short dpendens;
     bool is_need_process;
     transaction_priority transaction;
 
     transaction_dependent() : dpendens(0), is_need_process(false) {}
-    transaction_dependent(const hash_digest& _hash, unsigned short _dpendens, bool _is_need_process)
-        : dpendens(_dpendens), is_need_process(_is_need_process) { hash = make_shared<hash_digest>(_hash);}
 };
 
 miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_address)
 {
     block_ptr pblock;
-    vector<transaction_ptr> transactions;
+    vector<template_entry_ptr> entries;
     map<hash_digest, transaction_dependent> transaction_dependents;
-    previous_out_map_t previous_out_map;
-    tx_fee_map_t tx_fee_map;
-    get_transaction(transactions, previous_out_map, tx_fee_map);
+    unordered_map<hash_digest, size_t> tx_sigops_map;
+    get_template_entries(entries);
 
     vector<transaction_priority> transaction_prioritys;
     block_chain_impl& block_chain = node_.chain_impl();
@@ -412,37 +527,72 @@ miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_addr
     uint64_t total_fee = 0;
     unsigned int block_size = 0;
     unsigned int total_tx_sig_length = blockchain::validate_block::validate_block::legacy_sigops_count(*pblock->transactions.begin());
-    for (auto tx : transactions)
-    {
-        auto tx_hash = tx->hash();
-        double priority = 0;
-        for (const auto& input : tx->inputs)
-        {
-            auto prev_pair = previous_out_map[input.previous_output];
-            uint64_t prev_height = prev_pair.first;
-            const auto& prev_output = prev_pair.second;
-
-            if (prev_height != max_uint64) {
-                uint64_t input_value = prev_output.value;
-                priority += (double)input_value * (current_block_height - prev_height + 1);
-            }
-            else {
-                transaction_dependents[input.previous_output.hash].hash = make_shared<hash_digest>(tx_hash);
-                transaction_dependents[tx_hash].dpendens++;
+    unordered_map<hash_digest, size_t> entry_indexes;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        entry_indexes[entries[i]->tx->hash()] = i;
+    }
+
+    // This is a more accurate fee-per-kilobyte than is used by the client code, because the
+    // client code rounds up the size to the nearest 1K. That's good, because it gives an
+    // incentive to create smaller transactions.
+    vector<double> fee_per_kbs;
+    for (const auto& entry : entries) {
+        fee_per_kbs.push_back(double(entry->fee) / (double(entry->serialized_size) / 1000.0));
+    }
+
+    // A package is a transaction with all of its pool ancestors, scored by
+    // their combined fee rate. Each ancestor is ranked by the best package
+    // that needs it, so a high fee child pulls its parents forward.
+    for (size_t i = 0; i < entries.size(); ++i) {
+        set<size_t> ancestors;
+        vector<size_t> pending{i};
+        while (!pending.empty()) {
+            const auto index = pending.back();
+            pending.pop_back();
+            for (const auto& parent : entries[index]->parents) {
+                const auto it = entry_indexes.find(parent);
+                if (it != entry_indexes.end() && ancestors.insert(it->second).second) {
+                    pending.push_back(it->second);
+                }
             }
         }
 
-        uint64_t serialized_size = tx->serialized_size(0);
+        if (ancestors.empty()) {
+            continue;
+        }
+
+        uint64_t package_fee = entries[i]->fee;
+        uint64_t package_size = entries[i]->serialized_size;
+        for (const auto index : ancestors) {
+            package_fee += entries[index]->fee;
+            package_size += entries[index]->serialized_size;
+        }
+
+        const auto package_fee_per_kb = double(package_fee) / (double(package_size) / 1000.0);
+        for (const auto index : ancestors) {
+            fee_per_kbs[index] = max(fee_per_kbs[index], package_fee_per_kb);
+        }
+    }
+
+    for (size_t i = 0; i < entries.size(); ++i)
+    {
+        const auto& entry = entries[i];
+        const auto& tx = entry->tx;
+        auto tx_hash = tx->hash();
 
         // Priority is sum(valuein * age) / txsize
-        priority /= serialized_size;
+        double priority = entry->confirmed_value * (current_block_height + 1) - entry->confirmed_value_height;
+        priority /= entry->serialized_size;
+
+        // A transaction waits outside the heap until all of its parents are
+        // selected, then goes back into the heap under its own fee rate.
+        for (const auto& parent : entry->parents) {
+            transaction_dependents[parent].children.push_back(tx_hash);
+            transaction_dependents[tx_hash].dpendens++;
+        }
 
-        // This is a more accurate fee-per-kilobyte than is used by the client code, because the
-        // client code rounds up the size to the nearest 1K. That's good, because it gives an
-        // incentive to create smaller transactions.
-        auto tx_fee = tx_fee_map[tx_hash];
-        double fee_per_kb = double(tx_fee) / (double(serialized_size) / 1000.0);
-        transaction_prioritys.push_back(transaction_priority(priority, fee_per_kb, tx_fee, tx));
+        transaction_prioritys.push_back(transaction_priority(priority, fee_per_kbs[i], entry->fee, tx));
+        tx_sigops_map[tx_hash] = entry->sigops;
     }
 
     vector<transaction_ptr> blocked_transactions;
@@ -450,30 +600,18 @@ miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_addr
     bool is_resort = false;
     make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
 
-    transaction_priority *next_transaction_priority = NULL;
     uint32_t reward_lock_time = current_block_height - 1;
-    while (!transaction_prioritys.empty() || next_transaction_priority)
+    while (!transaction_prioritys.empty())
     {
-        transaction_priority temp_priority;
-        if (next_transaction_priority) {
-            temp_priority = *next_transaction_priority;
-        } else {
-            temp_priority = transaction_prioritys.front();
-        }
+        transaction_priority temp_priority = transaction_prioritys.front();
+        pop_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
+        transaction_prioritys.pop_back();
 
         double priority = temp_priority.get<0>();
         double fee_per_kb = temp_priority.get<1>();
         uint64_t fee = temp_priority.get<2>();
         transaction_ptr ptx = temp_priority.get<3>();
 
-        if (next_transaction_priority) {
-            next_transaction_priority = NULL;
-        }
-        else {
-            pop_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
-            transaction_prioritys.pop_back();
-        }
-
         hash_digest h = ptx->hash();
         if (transaction_dependents[h].dpendens != 0) {
             transaction_dependents[h].transaction = temp_priority;
@@ -506,8 +644,8 @@ miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_addr
         if (block_size + serialized_size >= block_max_size)
             continue;
 
-        // Legacy limits on sigOps:
-        unsigned int tx_sig_length = blockchain::validate_block::validate_block::legacy_sigops_count(*ptx);
+        // Legacy and pay-to-script-hash limits on sigOps:
+        unsigned int tx_sig_length = tx_sigops_map[h];
         if (total_tx_sig_length + tx_sig_length >= blockchain::max_block_script_sigops)
             continue;
 
@@ -525,12 +663,6 @@ miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_addr
             make_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
         }
 
-        size_t c;
-        if (!miner::script_hash_signature_operations_count(c, ptx->inputs, transactions)
-                && total_tx_sig_length + tx_sig_length + c >= blockchain::max_block_script_sigops)
-            continue;
-        tx_sig_length += c;
-
         blocked_transactions.push_back(ptx);
         for (auto& i : coinage_reward_coinbases) {
             pblock->transactions.push_back(*i);
@@ -540,10 +672,11 @@ miner::block_ptr miner::create_new_block(const wallet::payment_address& pay_addr
         total_tx_sig_length += tx_sig_length;
         total_fee += fee;
 
-        if (transaction_dependents[h].hash) {
-            transaction_dependent &d = transaction_dependents[*transaction_dependents[h].hash];
+        for (const auto& child : transaction_dependents[h].children) {
+            transaction_dependent &d = transaction_dependents[child];
             if (--d.dpendens == 0 && d.is_need_process) {
-                next_transaction_priority = &d.transaction;
+                transaction_prioritys.push_back(d.transaction);
+                push_heap(transaction_prioritys.begin(), transaction_prioritys.end(), sort_func);
             }
         }
     }
@@ -661,6 +794,7 @@ bool miner::is_stop_miner(uint64_t block_height) const
 
 bool miner::start(const wallet::payment_address& pay_address, uint16_t number)
 {
+    subscribe_template_updates();
     if (!thread_) {
         new_block_limit_ = number;
         thread_.reset(new boost::thread(bind(&miner::work, this, pay_address)));
@@ -728,8 +862,8 @@ bool miner::set_miner_payment_address(const bc::wallet::payment_address& address
 
 miner::block_ptr miner::get_block(bool is_force_create_block)
 {
-    static std::mutex mtx;
-    std::lock_guard<std::mutex> lock(mtx);
+    subscribe_template_updates();
+    std::lock_guard<std::mutex> lock(new_block_mutex_);
 
     if (is_force_create_block) {
         new_block_ = create_new_block(pay_address_);
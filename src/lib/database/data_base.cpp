@@ -22,6 +22,8 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <exception>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <algorithm>
@@ -135,6 +137,25 @@ bool data_base::initialize_mits(const path& prefix)
     return instance.stop();
 }
 
+// Blocks pushed before the undo table existed are popped without a journal.
+bool data_base::initialize_undos(const path& prefix)
+{
+    const store paths(prefix);
+    if (paths.undos_exist())
+        return true;
+    if (!paths.touch_undos())
+        return false;
+
+    data_base instance(prefix, 0, 0);
+    if (!instance.create_undos())
+        return false;
+
+    log::info(LOG_DATABASE)
+        << "Upgrading undo table is complete.";
+
+    return instance.stop();
+}
+
 bool data_base::upgrade_version_63(const path& prefix)
 {
     auto metadata_path = prefix / db_metadata::file_name;
@@ -165,6 +186,12 @@ bool data_base::upgrade_version_63(const path& prefix)
         return false;
     }
 
+    if (!initialize_undos(prefix)) {
+        log::error(LOG_DATABASE)
+            << "Failed to upgrade undo database.";
+        return false;
+    }
+
     if (metadata.version_ != db_metadata::current_version) {
         // write new db version to metadata
         metadata = db_metadata(db_metadata::current_version);
@@ -222,6 +249,8 @@ data_base::store::store(const path& prefix)
     address_mits_rows = prefix / "address_mit_row"; // for blockchain
     mit_history_lookup = prefix / "mit_history_table"; // for blockchain
     mit_history_rows = prefix / "mit_history_row"; // for blockchain
+    undos_even_lookup = prefix / "undo_even_table";
+    undos_odd_lookup = prefix / "undo_odd_table";
 
     // Height-based (reverse) lookup.
     blocks_index = prefix / "block_index";
@@ -263,7 +292,9 @@ bool data_base::store::touch_all() const
         touch_file(address_mits_lookup) &&
         touch_file(address_mits_rows) &&
         touch_file(mit_history_lookup) &&
-        touch_file(mit_history_rows);
+        touch_file(mit_history_rows) &&
+        touch_file(undos_even_lookup) &&
+        touch_file(undos_odd_lookup);
 }
 
 bool data_base::store::dids_exist() const
@@ -312,6 +343,20 @@ bool data_base::store::touch_mits() const
         touch_file(mit_history_rows);
 }
 
+bool data_base::store::undos_exist() const
+{
+    return
+        boost::filesystem::exists(undos_even_lookup) ||
+        boost::filesystem::exists(undos_odd_lookup);
+}
+
+bool data_base::store::touch_undos() const
+{
+    return
+        touch_file(undos_even_lookup) &&
+        touch_file(undos_odd_lookup);
+}
+
 data_base::db_metadata::db_metadata():version_("")
 {
 }
@@ -437,21 +482,22 @@ void data_base::uninitialize_lock(const path& lock)
 
 data_base::data_base(const settings& settings)
   : data_base(settings.directory, settings.history_start_height,
-        settings.stealth_start_height)
+        settings.stealth_start_height, settings.write_threads)
 {
 }
 
 data_base::data_base(const path& prefix, size_t history_height,
-    size_t stealth_height)
-  : data_base(store(prefix), history_height, stealth_height)
+    size_t stealth_height, size_t write_threads)
+  : data_base(store(prefix), history_height, stealth_height, write_threads)
 {
 }
 
 data_base::data_base(const store& paths, size_t history_height,
-    size_t stealth_height)
+    size_t stealth_height, size_t write_threads)
   : lock_file_path_(paths.database_lock),
     history_height_(history_height),
     stealth_height_(stealth_height),
+    write_threads_(write_threads),
     sequential_lock_(0),
     mutex_(std::make_shared<shared_mutex>()),
     blocks(paths.blocks_lookup, paths.blocks_index, mutex_),
@@ -471,7 +517,8 @@ data_base::data_base(const store& paths, size_t history_height,
     /* end database for account, asset, address_asset, did relationship */
     mits(paths.mits_lookup, mutex_),
     address_mits(paths.address_mits_lookup, paths.address_mits_rows, mutex_),
-    mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_)
+    mit_history(paths.mit_history_lookup, paths.mit_history_rows, mutex_),
+    undos(paths.undos_even_lookup, paths.undos_odd_lookup, mutex_)
 {
 }
 
@@ -531,7 +578,8 @@ bool data_base::create()
         /* end database for account, asset, address_asset relationship */
         mits.create() &&
         address_mits.create() &&
-        mit_history.create()
+        mit_history.create() &&
+        undos.create()
         ;
 }
 
@@ -556,6 +604,12 @@ bool data_base::create_mits()
         mit_history.create();
 }
 
+bool data_base::create_undos()
+{
+    return
+        undos.create();
+}
+
 // Start must be called before performing queries.
 // Start may be called after stop and/or after close in order to restart.
 bool data_base::start()
@@ -593,10 +647,13 @@ bool data_base::start()
         /* end database for account, asset, address_asset relationship */
         mits.start() &&
         address_mits.start() &&
-        mit_history.start()
+        mit_history.start() &&
+        undos.start()
         ;
     const auto end_exclusive = end_write();
 
+    writers_.spawn(write_threads_);
+
     // Return the result of the database start.
     return start_exclusive && start_result && end_exclusive;
 }
@@ -604,6 +661,9 @@ bool data_base::start()
 // Stop only accelerates work termination, only required if restarting.
 bool data_base::stop()
 {
+    writers_.shutdown();
+    writers_.join();
+
     const auto start_exclusive = begin_write();
     const auto blocks_stop = blocks.stop();
     const auto history_stop = history.stop();
@@ -623,6 +683,7 @@ bool data_base::stop()
     const auto mits_stop = mits.stop();
     const auto address_mits_stop = address_mits.stop();
     const auto mit_history_stop = mit_history.stop();
+    const auto undos_stop = undos.stop();
     const auto end_exclusive = end_write();
 
     // This should remove the lock file. This is not important for locking
@@ -651,6 +712,7 @@ bool data_base::stop()
         mits_stop &&
         address_mits_stop &&
         mit_history_stop &&
+        undos_stop &&
         end_exclusive;
 }
 
@@ -675,6 +737,7 @@ bool data_base::close()
     const auto mits_close = mits.close();
     const auto address_mits_close = address_mits.close();
     const auto mit_history_close = mit_history.close();
+    const auto undos_close = undos.close();
 
     // Return the cumulative result of the database closes.
     return
@@ -695,7 +758,8 @@ bool data_base::close()
         /* end database for account, asset, address_asset relationship */
         mits_close &&
         address_mits_close &&
-        mit_history_close
+        mit_history_close &&
+        undos_close
         ;
 }
 
@@ -769,6 +833,7 @@ void data_base::synchronize()
     mits.sync();
     address_mits.sync();
     mit_history.sync();
+    undos.sync();
     blocks.sync();
 }
 
@@ -798,85 +863,248 @@ void data_base::push(const block& block)
 
 void data_base::push(const block& block, uint64_t height)
 {
-    for (size_t index = 0; index < block.transactions.size(); ++index)
+    // Each write below targets its own databases, so they are applied in
+    // parallel. Within a database rows are written in block order, so the
+    // result is that of writing the transactions one after another.
+    static auto& stages = metrics::histogram("mvs_database_push_seconds",
+        "Block write time by database stage.", "stage");
+    static auto& spends_seconds = stages.get("spends");
+    static auto& history_seconds = stages.get("history");
+    static auto& assets_seconds = stages.get("assets");
+    static auto& stealth_seconds = stages.get("stealth");
+    static auto& transactions_seconds = stages.get("transactions");
+    static auto& undos_seconds = stages.get("undos");
+    static auto& blocks_seconds = stages.get("blocks");
+    static auto& synchronize_seconds = stages.get("synchronize");
+    typedef timer<asio::microseconds> stage_timer;
+
+    const auto& txs = block.transactions;
+    std::vector<hash_digest> tx_hashes;
+    tx_hashes.reserve(txs.size());
+
+    for (const auto& tx: txs)
+        tx_hashes.push_back(tx.hash());
+
+    // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
+    // We handle here because this is the lowest public level exposed.
+    const size_t first = !txs.empty() &&
+        is_allowed_duplicate(block.header, height) ? 1 : 0;
+
+    // for address_asset_database store_input/store_output used only
+    timestamp_ = block.header.timestamp;
+
+    const auto measure = [](metric_histogram& stage,
+        const std::function<void()>& handler)
     {
-        // Skip BIP30 allowed duplicates (coinbase txs of excepted blocks).
-        // We handle here because this is the lowest public level exposed.
-        if (index == 0 && is_allowed_duplicate(block.header, height))
-            continue;
+        return [&stage, handler]()
+        {
+            stage.observe_duration(stage_timer::duration(handler));
+        };
+    };
 
-        const auto& tx = block.transactions[index];
-        const auto tx_hash = tx.hash();
+    const write_list writes
+    {
+        // Address assets and attachments (assets, certs, dids and mits).
+        measure(assets_seconds, [&]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                push_assets(tx_hashes[index], height, txs[index]);
+        }),
 
-        timestamp_ = block.header.timestamp; // for address_asset_database store_input/store_output used only
-        // Add inputs
-        if (!tx.is_coinbase())
-            push_inputs(tx_hash, height, tx.inputs);
+        measure(history_seconds, [&]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                push_history(tx_hashes[index], height, txs[index]);
+        }),
 
-        std::string didaddress = tx.get_did_transfer_old_address();
-        if (!didaddress.empty()) {
-            data_chunk data(didaddress.begin(), didaddress.end());
-            short_hash key = ripemd160_hash(data);
-            address_dids.delete_old_did(key);
-        }
+        measure(spends_seconds, [&]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                if (!txs[index].is_coinbase())
+                    push_spends(tx_hashes[index], txs[index].inputs);
+        }),
 
-        // Add outputs
-        push_outputs(tx_hash, height, tx.outputs);
+        measure(stealth_seconds, [&]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                push_stealth(tx_hashes[index], height, txs[index].outputs);
+        }),
 
-        // Add stealth outputs
-        push_stealth(tx_hash, height, tx.outputs);
+        measure(transactions_seconds, [&]()
+        {
+            for (auto index = first; index < txs.size(); ++index)
+                transactions.store(height, index, txs[index]);
+        }),
 
-        // Add transaction
-        transactions.store(height, index, tx);
-    }
+        // The undo journal lists the rows that pop removes.
+        measure(undos_seconds, [&]()
+        {
+            undo_entry::list journal;
+            for (auto index = first; index < txs.size(); ++index)
+            {
+                if (!txs[index].is_coinbase())
+                    journal_inputs(journal, height, txs[index].inputs);
+
+                journal_outputs(journal, height, txs[index].outputs);
+            }
+
+            undos.store(height, block.header.hash(), journal);
+        }),
+
+        // Add block itself.
+        measure(blocks_seconds, [&]()
+        {
+            blocks.store(block, height);
+        })
+    };
 
-    // Add block itself.
-    blocks.store(block, height);
+    write(writes);
 
     // Synchronise everything that was added.
-    synchronize();
+    synchronize_seconds.observe_duration(stage_timer::duration([&]()
+    {
+        synchronize();
+    }));
+}
+
+// The first write runs on the calling thread, the rest on the write threads.
+// Without write threads they all run in order on the calling thread.
+void data_base::write(const write_list& writes)
+{
+    if (write_threads_ == 0)
+    {
+        for (const auto& handler: writes)
+            handler();
+
+        return;
+    }
+
+    std::vector<std::future<void>> results;
+    results.reserve(writes.size());
+
+    for (size_t index = 1; index < writes.size(); ++index)
+    {
+        const auto task = std::make_shared<std::packaged_task<void()>>(
+            writes[index]);
+        results.push_back(task->get_future());
+        writers_.service().post([task]() { (*task)(); });
+    }
+
+    // The writes reference the block, so all must finish before a throw.
+    std::exception_ptr error;
+
+    try
+    {
+        if (!writes.empty())
+            writes.front()();
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    for (auto& result: results)
+    {
+        try
+        {
+            result.get();
+        }
+        catch (...)
+        {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
 }
 
-void data_base::push_inputs(const hash_digest& tx_hash, size_t height,
-    const input::list& inputs)
+void data_base::push_spends(const hash_digest& tx_hash, const inputs& inputs)
 {
     for (uint32_t index = 0; index < inputs.size(); ++index)
     {
-        // We also push spends in the inputs loop.
-        const auto& input = inputs[index];
         const chain::input_point point{ tx_hash, index };
-        spends.store(input.previous_output, point);
+        spends.store(inputs[index].previous_output, point);
+    }
+}
 
-        if (height < history_height_)
-            continue;
+void data_base::push_history(const hash_digest& tx_hash, size_t height,
+    const chain::transaction& tx)
+{
+    if (height < history_height_)
+        return;
+
+    if (!tx.is_coinbase())
+    {
+        for (uint32_t index = 0; index < tx.inputs.size(); ++index)
+        {
+            const auto& input = tx.inputs[index];
+
+            // Try to extract an address.
+            const auto address = payment_address::extract(input.script);
+            if (!address)
+                continue;
+
+            const chain::input_point point{ tx_hash, index };
+            history.add_input(address.hash(), point, height,
+                input.previous_output);
+        }
+    }
+
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
+    {
+        const auto& output = tx.outputs[index];
 
         // Try to extract an address.
-        const auto address = payment_address::extract(input.script);
+        const auto address = payment_address::extract(output.script);
         if (!address)
             continue;
 
-        const auto& previous = input.previous_output;
-        history.add_input(address.hash(), point, height, previous);
-
-        /* begin added for asset issue/transfer */
-        auto address_str = address.encoded();
-        data_chunk data(address_str.begin(), address_str.end());
-        short_hash key = ripemd160_hash(data);
-        address_assets.store_input(key, point, height, previous, timestamp_);
-        address_assets.sync();
-        /* end added for asset issue/transfer */
+        const chain::output_point point{ tx_hash, index };
+        history.add_output(address.hash(), point, height, output.value);
     }
 }
 
-void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
-    const output::list& outputs)
+void data_base::push_assets(const hash_digest& tx_hash, size_t height,
+    const chain::transaction& tx)
 {
+    if (!tx.is_coinbase() && height >= history_height_)
+    {
+        for (uint32_t index = 0; index < tx.inputs.size(); ++index)
+        {
+            const auto& input = tx.inputs[index];
+
+            // Try to extract an address.
+            const auto address = payment_address::extract(input.script);
+            if (!address)
+                continue;
+
+            /* begin added for asset issue/transfer */
+            const chain::input_point point{ tx_hash, index };
+            auto address_str = address.encoded();
+            data_chunk data(address_str.begin(), address_str.end());
+            short_hash key = ripemd160_hash(data);
+            address_assets.store_input(key, point, height,
+                input.previous_output, timestamp_);
+            address_assets.sync();
+            /* end added for asset issue/transfer */
+        }
+    }
+
+    std::string didaddress = tx.get_did_transfer_old_address();
+    if (!didaddress.empty()) {
+        data_chunk data(didaddress.begin(), didaddress.end());
+        short_hash key = ripemd160_hash(data);
+        address_dids.delete_old_did(key);
+    }
+
     if (height < history_height_)
         return;
 
-    for (uint32_t index = 0; index < outputs.size(); ++index)
+    for (uint32_t index = 0; index < tx.outputs.size(); ++index)
     {
-        const auto& output = outputs[index];
+        const auto& output = tx.outputs[index];
         const chain::output_point point{ tx_hash, index };
 
         // Try to extract an address.
@@ -884,10 +1112,8 @@ void data_base::push_outputs(const hash_digest& tx_hash, size_t height,
         if (!address)
             continue;
 
-        const auto value = output.value;
-        history.add_output(address.hash(), point, height, value);
-
-        push_attachment(output.attach_data, address, point, height, value);
+        push_attachment(output.attach_data, address, point, height,
+            output.value);
     }
 }
 
@@ -965,20 +1191,36 @@ chain::block data_base::pop()
     }
 
     // Loop txs backwards, the reverse of how they are added.
-    // Remove txs, then outputs, then inputs (also reverse order).
     for (auto tx = txs.rbegin(); tx != txs.rend(); ++tx)
-    {
         transactions.remove(tx->hash());
-        pop_outputs(tx->outputs, height);
 
-        if (!tx->is_coinbase())
-            pop_inputs(tx->inputs, height);
+    // Remove the rows the block wrote. Blocks pushed before the undo table
+    // existed or too far below the top have no journal, so it is derived
+    // from the transactions.
+    const auto block_hash = block.header.hash();
+    auto journal = undos.get(block_hash);
+    if (journal)
+    {
+        undos.remove(block_hash);
+    }
+    else
+    {
+        journal = std::make_shared<undo_entry::list>();
+        for (const auto& tx: txs)
+        {
+            if (!tx.is_coinbase())
+                journal_inputs(*journal, height, tx.inputs);
+
+            journal_outputs(*journal, height, tx.outputs);
+        }
     }
 
+    undo(*journal);
+
     // Stealth unlink is not implemented.
     stealth.unlink(height);
     blocks.unlink(height);
-    blocks.remove(block.header.hash()); // wdy remove block from block hash table
+    blocks.remove(block_hash); // wdy remove block from block hash table
 
     // Synchronise everything that was changed.
     synchronize();
@@ -987,115 +1229,163 @@ chain::block data_base::pop()
     return block;
 }
 
-void data_base::pop_inputs(const input::list& inputs, size_t height)
+// The address key of the address asset, did and mit tables.
+static short_hash to_address_key(const payment_address& address)
+{
+    const auto encoded = address.encoded();
+    return ripemd160_hash(data_chunk(encoded.begin(), encoded.end()));
+}
+
+static hash_digest to_symbol_hash(const std::string& symbol)
+{
+    return sha256_hash(data_chunk(symbol.begin(), symbol.end()));
+}
+
+void data_base::journal_inputs(undo_entry::list& journal, size_t height,
+    const inputs& inputs) const
 {
-    // Loop in reverse.
-    for (auto input = inputs.rbegin(); input != inputs.rend(); ++input)
+    for (const auto& input: inputs)
     {
-        spends.remove(input->previous_output);
+        const auto& previous = input.previous_output;
+        journal.push_back({ undo_entry::kind::spend, {}, previous.hash,
+            previous.index });
 
         if (height < history_height_)
             continue;
 
         // Try to extract an address.
-        const auto address = payment_address::extract(input->script);
+        const auto address = payment_address::extract(input.script);
+        if (!address)
+            continue;
 
-        if (address) {
-            history.delete_last_row(address.hash());
-            // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
-            address_assets.delete_last_row(hash);
-        }
+        journal.push_back({ undo_entry::kind::history, address.hash() });
+        journal.push_back({ undo_entry::kind::address_asset,
+            to_address_key(address) });
     }
 }
 
-void data_base::pop_outputs(const output::list& outputs, size_t height)
+void data_base::journal_outputs(undo_entry::list& journal, size_t height,
+    const outputs& outputs) const
 {
     if (height < history_height_)
         return;
 
-    // Loop in reverse.
-    for (auto output = outputs.rbegin(); output != outputs.rend(); ++output)
+    for (const auto& output: outputs)
     {
         // Try to extract an address.
-        const auto address = payment_address::extract(output->script);
+        const auto address = payment_address::extract(output.script);
+        if (!address)
+            continue;
 
-        if (address) {
-            history.delete_last_row(address.hash());
-            // delete address asset record
-            auto address_str = address.encoded();
-            data_chunk data(address_str.begin(), address_str.end());
-            short_hash hash = ripemd160_hash(data);
-            address_assets.delete_last_row(hash);
-            // remove asset or did from database
-            bc::chain::output op = *output;
-            if (op.is_asset_issue() || op.is_asset_secondaryissue()) {
-                auto symbol = op.get_asset_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
-                const auto symbol_hash = sha256_hash(symbol_data);
-                assets.remove(symbol_hash);
-            }
-            else if (op.is_did()) {
-                auto symbol = op.get_did_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
-                const auto symbol_hash = sha256_hash(symbol_data);
-
-                if(op.is_did_register())
-                {
-                    address_dids.delete_last_row(hash);
-                    address_dids.sync();
-                    dids.remove(symbol_hash);
-                    dids.sync();
-                }
-                else if(op.is_did_transfer() )
-                {
-                    std::shared_ptr<blockchain_did> blockchain_did_=  dids.pop_did_transfer(symbol_hash);
-                    dids.sync();
-
-                    if(blockchain_did_)
-                    {
-                        auto old_address = blockchain_did_->get_did().get_address();
-                        data_chunk data_old(old_address.begin(), old_address.end());
-                        short_hash old_hash = ripemd160_hash(data_old);
-
-                        address_dids.delete_last_row(old_hash);
-                        address_dids.delete_last_row(hash);
-
-                        address_dids.store_output(old_hash, blockchain_did_->get_tx_point(), blockchain_did_->get_height(), 0,
-                            static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
-                            timestamp_, blockchain_did_->get_did());
-                        address_dids.sync();
-
-                    }
-                }
+        const auto key = to_address_key(address);
+        journal.push_back({ undo_entry::kind::history, address.hash() });
+        journal.push_back({ undo_entry::kind::address_asset, key });
 
+        // Attachment rows are listed in reverse of their removal order.
+        if (output.is_asset_issue() || output.is_asset_secondaryissue())
+        {
+            journal.push_back({ undo_entry::kind::asset, {},
+                to_symbol_hash(output.get_asset_symbol()) });
+        }
+        else if (output.is_did())
+        {
+            const auto symbol_hash = to_symbol_hash(output.get_did_symbol());
+
+            if (output.is_did_register())
+            {
+                journal.push_back({ undo_entry::kind::did, {}, symbol_hash });
+                journal.push_back({ undo_entry::kind::address_did, key });
             }
-            else if (op.is_asset_cert()) {
-                const auto asset_cert = op.get_asset_cert();
-                if (asset_cert.is_newly_generated()) {
-                    const auto key_str = asset_cert.get_key();
-                    const data_chunk& data = data_chunk(key_str.begin(), key_str.end());
-                    const auto key_hash = sha256_hash(data);
-                    certs.remove(key_hash);
-                }
+            else if (output.is_did_transfer())
+            {
+                journal.push_back({ undo_entry::kind::did_transfer, key,
+                    symbol_hash });
             }
-            else if (op.is_asset_mit()) {
-                address_mits.delete_last_row(hash);
+        }
+        else if (output.is_asset_cert())
+        {
+            const auto cert = output.get_asset_cert();
+            if (cert.is_newly_generated())
+                journal.push_back({ undo_entry::kind::cert, {},
+                    to_symbol_hash(cert.get_key()) });
+        }
+        else if (output.is_asset_mit())
+        {
+            const auto mit = output.get_asset_mit();
+            const auto symbol = mit.get_symbol();
+            const data_chunk symbol_data(symbol.begin(), symbol.end());
 
-                const auto mit = op.get_asset_mit();
-                auto symbol = mit.get_symbol();
-                const data_chunk& symbol_data = data_chunk(symbol.begin(), symbol.end());
+            if (mit.is_register_status())
+                journal.push_back({ undo_entry::kind::mit, {},
+                    sha256_hash(symbol_data) });
 
-                const auto symbol_short_hash = ripemd160_hash(symbol_data);
-                mit_history.delete_last_row(symbol_short_hash);
+            journal.push_back({ undo_entry::kind::mit_history,
+                ripemd160_hash(symbol_data) });
+            journal.push_back({ undo_entry::kind::address_mit, key });
+        }
+    }
+}
 
-                if (mit.is_register_status()) {
-                    const auto symbol_hash = sha256_hash(symbol_data);
-                    mits.remove(symbol_hash);
-                }
+// Rows are removed in reverse of the order they were written.
+void data_base::undo(const undo_entry::list& journal)
+{
+    for (auto entry = journal.rbegin(); entry != journal.rend(); ++entry)
+    {
+        switch (entry->action)
+        {
+            case undo_entry::kind::spend:
+                spends.remove({ entry->hash, entry->index });
+                break;
+            case undo_entry::kind::history:
+                history.delete_last_row(entry->address);
+                break;
+            case undo_entry::kind::address_asset:
+                address_assets.delete_last_row(entry->address);
+                break;
+            case undo_entry::kind::asset:
+                assets.remove(entry->hash);
+                break;
+            case undo_entry::kind::address_did:
+                address_dids.delete_last_row(entry->address);
+                address_dids.sync();
+                break;
+            case undo_entry::kind::did:
+                dids.remove(entry->hash);
+                dids.sync();
+                break;
+            case undo_entry::kind::did_transfer:
+            {
+                const auto blockchain_did = dids.pop_did_transfer(entry->hash);
+                dids.sync();
+
+                if (!blockchain_did)
+                    break;
+
+                auto old_address = blockchain_did->get_did().get_address();
+                data_chunk data_old(old_address.begin(), old_address.end());
+                short_hash old_hash = ripemd160_hash(data_old);
+
+                address_dids.delete_last_row(old_hash);
+                address_dids.delete_last_row(entry->address);
+
+                address_dids.store_output(old_hash, blockchain_did->get_tx_point(), blockchain_did->get_height(), 0,
+                    static_cast<typename std::underlying_type<business_kind>::type>(business_kind::did_register),
+                    timestamp_, blockchain_did->get_did());
+                address_dids.sync();
+                break;
             }
+            case undo_entry::kind::cert:
+                certs.remove(entry->hash);
+                break;
+            case undo_entry::kind::address_mit:
+                address_mits.delete_last_row(entry->address);
+                break;
+            case undo_entry::kind::mit_history:
+                mit_history.delete_last_row(entry->address);
+                break;
+            case undo_entry::kind::mit:
+                mits.remove(entry->hash);
+                break;
         }
     }
 }
@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/database/databases/undo_database.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory.hpp>
+
+namespace libbitcoin {
+namespace database {
+
+using namespace boost::filesystem;
+
+// Journals are kept for between undo_depth and twice as many blocks.
+BC_CONSTEXPR size_t undo_depth = 1000;
+BC_CONSTEXPR size_t number_buckets = 4 * undo_depth;
+BC_CONSTEXPR size_t header_size = slab_hash_table_header_size(number_buckets);
+BC_CONSTEXPR size_t initial_map_file_size = header_size + minimum_slabs_size;
+
+// Each entry is the kind followed by only the fields the kind uses.
+static size_t serialized_size(const undo_entry& entry)
+{
+    switch (entry.action)
+    {
+        case undo_entry::kind::spend:
+            return 1 + hash_size + sizeof(uint32_t);
+        case undo_entry::kind::did_transfer:
+            return 1 + short_hash_size + hash_size;
+        case undo_entry::kind::asset:
+        case undo_entry::kind::did:
+        case undo_entry::kind::cert:
+        case undo_entry::kind::mit:
+            return 1 + hash_size;
+        default:
+            return 1 + short_hash_size;
+    }
+}
+
+undo_database::table::table(const path& map_filename,
+    std::shared_ptr<shared_mutex> mutex)
+  : lookup_file(map_filename, mutex),
+    lookup_header(lookup_file, number_buckets),
+    lookup_manager(lookup_file, header_size),
+    lookup_map(lookup_header, lookup_manager)
+{
+}
+
+// Initialize files and start.
+bool undo_database::table::create()
+{
+    // Resize and create require a started file.
+    if (!lookup_file.start())
+        return false;
+
+    // This will throw if insufficient disk space.
+    lookup_file.resize(initial_map_file_size);
+
+    if (!lookup_header.create() ||
+        !lookup_manager.create())
+        return false;
+
+    // Should not call start after create, already started.
+    return
+        lookup_header.start() &&
+        lookup_manager.start();
+}
+
+// Start files and primitives.
+bool undo_database::table::start()
+{
+    return
+        lookup_file.start() &&
+        lookup_header.start() &&
+        lookup_manager.start();
+}
+
+// Empty the buckets and the slabs, the file keeps its size.
+void undo_database::table::clear()
+{
+    lookup_header.create();
+    lookup_manager.clear();
+}
+
+undo_database::undo_database(const path& even_filename,
+    const path& odd_filename, std::shared_ptr<shared_mutex> mutex)
+  : tables_{ { even_filename, mutex }, { odd_filename, mutex } }
+{
+}
+
+// Close does not call stop because there is no way to detect thread join.
+undo_database::~undo_database()
+{
+    close();
+}
+
+// Create.
+// ----------------------------------------------------------------------------
+
+bool undo_database::create()
+{
+    return
+        tables_[0].create() &&
+        tables_[1].create();
+}
+
+// Startup and shutdown.
+// ----------------------------------------------------------------------------
+
+bool undo_database::start()
+{
+    return
+        tables_[0].start() &&
+        tables_[1].start();
+}
+
+// Stop files.
+bool undo_database::stop()
+{
+    const auto even_stop = tables_[0].lookup_file.stop();
+    const auto odd_stop = tables_[1].lookup_file.stop();
+    return even_stop && odd_stop;
+}
+
+// Close files.
+bool undo_database::close()
+{
+    const auto even_close = tables_[0].lookup_file.close();
+    const auto odd_close = tables_[1].lookup_file.close();
+    return even_close && odd_close;
+}
+
+// ----------------------------------------------------------------------------
+
+std::shared_ptr<undo_entry::list> undo_database::get(
+    const hash_digest& block_hash) const
+{
+    auto raw_memory = tables_[0].lookup_map.find(block_hash);
+    if (!raw_memory)
+        raw_memory = tables_[1].lookup_map.find(block_hash);
+
+    if (!raw_memory)
+        return nullptr;
+
+    const auto memory = REMAP_ADDRESS(raw_memory);
+    auto deserial = make_deserializer_unsafe(memory);
+    const auto count = deserial.read_4_bytes_little_endian();
+
+    auto journal = std::make_shared<undo_entry::list>(count);
+    for (auto& entry: *journal)
+    {
+        entry.action = static_cast<undo_entry::kind>(deserial.read_byte());
+
+        switch (entry.action)
+        {
+            case undo_entry::kind::spend:
+                entry.hash = deserial.read_hash();
+                entry.index = deserial.read_4_bytes_little_endian();
+                break;
+            case undo_entry::kind::did_transfer:
+                entry.address = deserial.read_short_hash();
+                entry.hash = deserial.read_hash();
+                break;
+            case undo_entry::kind::asset:
+            case undo_entry::kind::did:
+            case undo_entry::kind::cert:
+            case undo_entry::kind::mit:
+                entry.hash = deserial.read_hash();
+                break;
+            default:
+                entry.address = deserial.read_short_hash();
+                break;
+        }
+    }
+
+    return journal;
+}
+
+void undo_database::store(size_t height, const hash_digest& block_hash,
+    const undo_entry::list& journal)
+{
+    // The journals of the table being entered are undo_depth blocks below
+    // the top or more. A pop to below them derives the rows instead.
+    auto& table = tables_[(height / undo_depth) % 2];
+    if (height % undo_depth == 0)
+        table.clear();
+
+    size_t value_size = sizeof(uint32_t);
+    for (const auto& entry: journal)
+        value_size += serialized_size(entry);
+
+    auto write = [&journal](memory_ptr data)
+    {
+        auto serial = make_serializer(REMAP_ADDRESS(data));
+        serial.write_4_bytes_little_endian(
+            static_cast<uint32_t>(journal.size()));
+
+        for (const auto& entry: journal)
+        {
+            serial.write_byte(static_cast<uint8_t>(entry.action));
+
+            switch (entry.action)
+            {
+                case undo_entry::kind::spend:
+                    serial.write_hash(entry.hash);
+                    serial.write_4_bytes_little_endian(entry.index);
+                    break;
+                case undo_entry::kind::did_transfer:
+                    serial.write_short_hash(entry.address);
+                    serial.write_hash(entry.hash);
+                    break;
+                case undo_entry::kind::asset:
+                case undo_entry::kind::did:
+                case undo_entry::kind::cert:
+                case undo_entry::kind::mit:
+                    serial.write_hash(entry.hash);
+                    break;
+                default:
+                    serial.write_short_hash(entry.address);
+                    break;
+            }
+        }
+    };
+
+    table.lookup_map.store(block_hash, write, value_size);
+}
+
+void undo_database::remove(const hash_digest& block_hash)
+{
+    if (!tables_[0].lookup_map.unlink(block_hash))
+        tables_[1].lookup_map.unlink(block_hash);
+}
+
+void undo_database::sync()
+{
+    tables_[0].lookup_manager.sync();
+    tables_[1].lookup_manager.sync();
+}
+
+} // namespace database
+} // namespace libbitcoin
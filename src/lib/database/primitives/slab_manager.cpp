@@ -95,6 +95,20 @@ void slab_manager::sync() const
     ///////////////////////////////////////////////////////////////////////////
 }
 
+void slab_manager::clear()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    ALLOCATE_WRITE(mutex_);
+
+    payload_size_ = sizeof(file_offset);
+
+    // The file is not truncated, its space is reused by new slabs.
+    file_.resize(header_size_ + payload_size_);
+    write_size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
 // protected
 file_offset slab_manager::payload_size() const
 {
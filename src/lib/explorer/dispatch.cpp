@@ -21,7 +21,9 @@
 #include <metaverse/explorer/dispatch.hpp>
 
 #include <iostream>
+#include <sstream>
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
 #include <boost/program_options.hpp>
 #include <metaverse/explorer/command.hpp>
@@ -80,6 +82,43 @@ static std::ostream& get_command_error(command& command, std::ostream& error)
     return error;
 }
 
+// Invoke a parsed command on behalf of the server.
+static console_result invoke_command(command& command, parser& metadata,
+    std::ostringstream& output, Json::Value& jv_output,
+    libbitcoin::server::server_node& node, uint8_t api_version)
+{
+    if (metadata.help())
+    {
+        command.write_help(output);
+        jv_output = output.str();
+        return console_result::okay;
+    }
+
+    command.set_api_version(api_version);
+
+    if (command.category(ctgy_extension))
+    {
+        // fixme. is_blockchain_sync has some problem.
+        // if (command.category(ctgy_online) && node.is_blockchain_sync()) {
+        if (command.category(ctgy_online) &&
+            !node.chain_impl().chain_settings().use_testnet_rules) {
+            uint64_t height{0};
+            node.chain_impl().get_last_height(height);
+            if (!command.is_block_height_fullfilled(height)) {
+                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
+            }
+        }
+
+        return static_cast<commands::command_extension&>(command).invoke(jv_output, node);
+    }
+    else {
+        command.set_api_version(1); // only compatible for v1
+        auto retcode = command.invoke(output, output);
+        jv_output = output.str();
+        return retcode;
+    }
+}
+
 console_result dispatch(int argc, const char* argv[],
     std::istream& input, std::ostream& output, std::ostream& error)
 {
@@ -158,36 +197,40 @@ console_result dispatch_command(int argc, const char* argv[],
         throw command_params_exception{ output.str() };
     }
 
-    if (metadata.help())
+    return invoke_command(*command, metadata, output, jv_output, node,
+        api_version);
+}
+
+console_result dispatch_command(const std::string& target,
+    const Json::Value& options, const std::vector<std::string>& arguments,
+    Json::Value& jv_output, libbitcoin::server::server_node& node,
+    uint8_t api_version)
+{
+    std::istringstream input;
+    std::ostringstream output;
+
+    const auto command = find(target);
+
+    if (!command)
     {
-        command->write_help(output);
-        jv_output = output.str();
-        return console_result::okay;
+        const std::string superseding(formerly(target));
+        display_invalid_command(output, target, superseding);
+        throw invalid_command_exception{ output.str() };
     }
 
-    command->set_api_version(api_version);
+    auto& in = get_command_input(*command, input);
 
-    if (command->category(ctgy_extension))
-    {
-        // fixme. is_blockchain_sync has some problem.
-        // if (command->category(ctgy_online) && node.is_blockchain_sync()) {
-        if (command->category(ctgy_online) &&
-            !node.chain_impl().chain_settings().use_testnet_rules) {
-            uint64_t height{0};
-            node.chain_impl().get_last_height(height);
-            if (!command->is_block_height_fullfilled(height)) {
-                throw block_sync_required_exception{"This command is unavailable because of the height < 610000."};
-            }
-        }
+    parser metadata(*command);
+    std::string error_message;
 
-        return static_cast<commands::command_extension*>(command.get())->invoke(jv_output, node);
-    }
-    else {
-        command->set_api_version(1); // only compatible for v1
-        auto retcode = command->invoke(output, output);
-        jv_output = output.str();
-        return retcode;
+    if (!metadata.parse(error_message, in, options, arguments))
+    {
+        display_invalid_parameter(output, error_message);
+        throw command_params_exception{ output.str() };
     }
+
+    return invoke_command(*command, metadata, output, jv_output, node,
+        api_version);
 }
 
 
@@ -22,6 +22,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <array>
 
 #include <metaverse/explorer/command.hpp>
@@ -215,182 +216,160 @@ void broadcast_extension(const function<void(shared_ptr<command>)> func, std::os
     func(make_shared<getdid>());
 }
 
-shared_ptr<command> find_extension(const string& symbol)
+typedef std::function<shared_ptr<command>()> command_factory;
+typedef std::unordered_map<std::string, command_factory> command_registry;
+
+static void add(command_registry& registry, const std::string& name,
+    command_factory&& factory)
+{
+    const auto inserted = registry.emplace(name, std::move(factory));
+    BITCOIN_ASSERT_MSG(inserted.second, "duplicate command name");
+}
+
+// Register a command under its symbol or an alias.
+template <typename Command>
+static void add(command_registry& registry,
+    const std::string& name=Command::symbol())
+{
+    add(registry, name, []() { return make_shared<Command>(); });
+}
+
+// Register an alias that is passed to the command constructor.
+template <typename Command>
+static void add_named(command_registry& registry, const std::string& name)
+{
+    add(registry, name, [name]() { return make_shared<Command>(name); });
+}
+
+static command_registry make_extensions()
 {
-    using namespace std;
     using namespace commands;
 
+    command_registry registry;
+
     // account
-    if (symbol == getnewaccount::symbol())
-        return make_shared<getnewaccount>();
-    if (symbol == getaccount::symbol())
-        return make_shared<getaccount>();
-    if (symbol == deleteaccount::symbol())
-        return make_shared<deleteaccount>();
-    if (symbol == changepasswd::symbol())
-        return make_shared<changepasswd>();
-    if (symbol == validateaddress::symbol())
-        return make_shared<validateaddress>();
-    if (symbol == getnewaddress::symbol())
-        return make_shared<getnewaddress>();
-    if (symbol == listaddresses::symbol())
-        return make_shared<listaddresses>();
-    if (symbol == importaccount::symbol())
-        return make_shared<importaccount>();
-    if (symbol == dumpkeyfile::symbol() || symbol == "exportaccountasfile")
-        return make_shared<dumpkeyfile>();
-    if (symbol == importkeyfile::symbol() || symbol == "importaccountfromfile")
-        return make_shared<importkeyfile>();
+    add<getnewaccount>(registry);
+    add<getaccount>(registry);
+    add<deleteaccount>(registry);
+    add<changepasswd>(registry);
+    add<validateaddress>(registry);
+    add<getnewaddress>(registry);
+    add<listaddresses>(registry);
+    add<importaccount>(registry);
+    add<dumpkeyfile>(registry);
+    add<dumpkeyfile>(registry, "exportaccountasfile");
+    add<importkeyfile>(registry);
+    add<importkeyfile>(registry, "importaccountfromfile");
 
     // system
-    if (symbol == shutdown::symbol())
-        return make_shared<shutdown>();
-    if (symbol == getinfo::symbol())
-        return make_shared<getinfo>();
-    if (symbol == addnode::symbol())
-        return make_shared<addnode>();
-    if (symbol == getpeerinfo::symbol())
-        return make_shared<getpeerinfo>();
+    add<shutdown>(registry);
+    add<getinfo>(registry);
+    add<addnode>(registry);
+    add<getpeerinfo>(registry);
 
     // mining
-    if (symbol == stopmining::symbol() || symbol == "stop")
-        return make_shared<stopmining>();
-    if (symbol == startmining::symbol() || symbol == "start")
-        return make_shared<startmining>();
-    if (symbol == setminingaccount::symbol())
-        return make_shared<setminingaccount>();
-    if (symbol == getmininginfo::symbol())
-        return make_shared<getmininginfo>();
-    if ((symbol == getwork::symbol()) || (symbol == "eth_getWork"))
-        return make_shared<getwork>();
-    if ((symbol == submitwork::symbol()) || ( symbol == "eth_submitWork"))
-        return make_shared<submitwork>();
-    if (symbol == getmemorypool::symbol())
-        return make_shared<getmemorypool>();
+    add<stopmining>(registry);
+    add<stopmining>(registry, "stop");
+    add<startmining>(registry);
+    add<startmining>(registry, "start");
+    add<setminingaccount>(registry);
+    add<getmininginfo>(registry);
+    add<getwork>(registry);
+    add<getwork>(registry, "eth_getWork");
+    add<submitwork>(registry);
+    add<submitwork>(registry, "eth_submitWork");
+    add<getmemorypool>(registry);
 
     // block & tx
-    if (symbol == getheight::symbol())
-        return make_shared<getheight>();
-    if (symbol == "fetch-height")
-        return make_shared<getheight>(symbol);
-    if (symbol == getblock::symbol())
-        return make_shared<getblock>();
-    if (symbol == "getbestblockhash")
-        return make_shared<getblockheader>(symbol);
-    if (symbol == getblockheader::symbol() || symbol == "fetch-header" || symbol == "getbestblockheader")
-        return make_shared<getblockheader>();
-    if (symbol == fetchheaderext::symbol())
-        return make_shared<fetchheaderext>();
-    if (symbol == gettx::symbol() || symbol == "gettransaction")
-        return make_shared<gettx>();
-    if (symbol == "fetch-tx")
-        return make_shared<gettx>(symbol);
-    if (symbol == listtxs::symbol())
-        return make_shared<listtxs>();
+    add<getheight>(registry);
+    add_named<getheight>(registry, "fetch-height");
+    add<getblock>(registry);
+    add_named<getblockheader>(registry, "getbestblockhash");
+    add<getblockheader>(registry);
+    add<getblockheader>(registry, "fetch-header");
+    add<getblockheader>(registry, "getbestblockheader");
+    add<fetchheaderext>(registry);
+    add<gettx>(registry);
+    add<gettx>(registry, "gettransaction");
+    add_named<gettx>(registry, "fetch-tx");
+    add<listtxs>(registry);
 
     // raw tx
-    if (symbol == createrawtx::symbol())
-        return make_shared<createrawtx>();
-    if (symbol == decoderawtx::symbol())
-        return make_shared<decoderawtx>();
-    if (symbol == signrawtx::symbol())
-        return make_shared<signrawtx>();
-    if (symbol == sendrawtx::symbol())
-        return make_shared<sendrawtx>();
+    add<createrawtx>(registry);
+    add<decoderawtx>(registry);
+    add<signrawtx>(registry);
+    add<sendrawtx>(registry);
 
     // multi-sig
-    if (symbol == getpublickey::symbol())
-        return make_shared<getpublickey>();
-    if (symbol == getnewmultisig::symbol())
-        return make_shared<getnewmultisig>();
-    if (symbol == listmultisig::symbol())
-        return make_shared<listmultisig>();
-    if (symbol == deletemultisig::symbol())
-        return make_shared<deletemultisig>();
-    if (symbol == createmultisigtx::symbol())
-        return make_shared<createmultisigtx>();
-    if (symbol == signmultisigtx::symbol())
-        return make_shared<signmultisigtx>();
+    add<getpublickey>(registry);
+    add<getnewmultisig>(registry);
+    add<listmultisig>(registry);
+    add<deletemultisig>(registry);
+    add<createmultisigtx>(registry);
+    add<signmultisigtx>(registry);
 
     // etp
-    if (symbol == listbalances::symbol())
-        return make_shared<listbalances>();
-    if (symbol == getbalance::symbol())
-        return make_shared<getbalance>();
-    if (symbol == getaddressetp::symbol() || symbol == "fetch-balance")
-        return make_shared<getaddressetp>();
-    if (symbol == deposit::symbol())
-        return make_shared<deposit>();
-    if (symbol == send::symbol())
-        return make_shared<send>();
-    if (symbol == sendmore::symbol())
-        return make_shared<sendmore>();
-    if (symbol == sendfrom::symbol())
-        return make_shared<sendfrom>();
+    add<listbalances>(registry);
+    add<getbalance>(registry);
+    add<getaddressetp>(registry);
+    add<getaddressetp>(registry, "fetch-balance");
+    add<deposit>(registry);
+    add<send>(registry);
+    add<sendmore>(registry);
+    add<sendfrom>(registry);
 
     // asset
-    if (symbol == createasset::symbol())
-        return make_shared<createasset>();
-    if (symbol == deletelocalasset::symbol() || symbol == "deleteasset" )
-        return make_shared<deletelocalasset>();
-    if (symbol == listassets::symbol())
-        return make_shared<listassets>();
-    if (symbol == getasset::symbol())
-        return make_shared<getasset>();
-    if (symbol == getaccountasset::symbol())
-        return make_shared<getaccountasset>();
-    if (symbol == getaddressasset::symbol())
-        return make_shared<getaddressasset>();
-    if (symbol == issue::symbol())
-        return make_shared<issue>();
-    // if (symbol == issuefrom::symbol())
-    //     return make_shared<issuefrom>();
-    if (symbol == secondaryissue::symbol() || (symbol == "additionalissue") )
-        return make_shared<secondaryissue>();
-    if (symbol == sendasset::symbol())
-        return make_shared<sendasset>();
-    if (symbol == sendassetfrom::symbol())
-        return make_shared<sendassetfrom>();
-    if (symbol == burn::symbol())
-        return make_shared<burn>();
+    add<createasset>(registry);
+    add<deletelocalasset>(registry);
+    add<deletelocalasset>(registry, "deleteasset");
+    add<listassets>(registry);
+    add<getasset>(registry);
+    add<getaccountasset>(registry);
+    add<getaddressasset>(registry);
+    add<issue>(registry);
+    // add<issuefrom>(registry);
+    add<secondaryissue>(registry);
+    add<secondaryissue>(registry, "additionalissue");
+    add<sendasset>(registry);
+    add<sendassetfrom>(registry);
+    add<burn>(registry);
 
     // cert
-    if (symbol == transfercert::symbol())
-        return make_shared<transfercert>();
-    if (symbol == issuecert::symbol())
-        return make_shared<issuecert>();
+    add<transfercert>(registry);
+    add<issuecert>(registry);
 
     // mit
-    if (symbol == registermit::symbol())
-        return make_shared<registermit>();
-    if (symbol == transfermit::symbol())
-        return make_shared<transfermit>();
-    if (symbol == listmits::symbol())
-        return make_shared<listmits>();
-    if (symbol == getmit::symbol())
-        return make_shared<getmit>();
+    add<registermit>(registry);
+    add<transfermit>(registry);
+    add<listmits>(registry);
+    add<getmit>(registry);
 
     // did
-    if (symbol == registerdid::symbol())
-        return make_shared<registerdid>();
-    if (symbol == didsend::symbol())
-        return make_shared<didsend>();
-    if (symbol == didsendasset::symbol())
-        return make_shared<didsendasset>();
-    if (symbol == didsendfrom::symbol())
-        return make_shared<didsendfrom>();
-    if (symbol == didsendmore::symbol())
-        return make_shared<didsendmore>();
-    if (symbol == didsendassetfrom::symbol())
-        return make_shared<didsendassetfrom>();
-    if (symbol == didchangeaddress::symbol())
-        return make_shared<didchangeaddress>();
-    if (symbol == listdids::symbol())
-        return make_shared<listdids>();
-    if (symbol == getdid::symbol())
-        return make_shared<getdid>();
-
-    return nullptr;
+    add<registerdid>(registry);
+    add<didsend>(registry);
+    add<didsendasset>(registry);
+    add<didsendfrom>(registry);
+    add<didsendmore>(registry);
+    add<didsendassetfrom>(registry);
+    add<didchangeaddress>(registry);
+    add<listdids>(registry);
+    add<getdid>(registry);
+
+    return registry;
+}
+
+// The factories by name, built once on first lookup.
+static const command_registry& extensions()
+{
+    static const auto registry = make_extensions();
+    return registry;
+}
+
+shared_ptr<command> find_extension(const string& symbol)
+{
+    const auto& registry = extensions();
+    const auto it = registry.find(symbol);
+    return it == registry.end() ? nullptr : it->second();
 }
 
 std::string formerly_extension(const string& former)
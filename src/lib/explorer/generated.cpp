@@ -23,6 +23,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <metaverse/explorer/command.hpp>
 #include <metaverse/explorer/extensions/command_extension.hpp>
@@ -59,30 +60,34 @@ void broadcast(const function<void(shared_ptr<command>)> func, std::ostream& os)
     broadcast_extension(func, os);
 }
 
+typedef function<shared_ptr<command>()> command_factory;
+
+template <typename Command>
+static pair<string, command_factory> factory()
+{
+    return { Command::symbol(), []() { return make_shared<Command>(); } };
+}
+
 shared_ptr<command> find(const string& symbol)
 {
-    if (symbol == help::symbol())
-        return make_shared<help>();
-    if (symbol == send_tx::symbol())
-        return make_shared<send_tx>();
-    if (symbol == settings::symbol())
-        return make_shared<settings>();
-    if (symbol == fetch_history::symbol())
-        return make_shared<fetch_history>();
-    if (symbol == stealth_decode::symbol())
-        return make_shared<stealth_decode>();
-    if (symbol == stealth_encode::symbol())
-        return make_shared<stealth_encode>();
-    if (symbol == stealth_public::symbol())
-        return make_shared<stealth_public>();
-    if (symbol == stealth_secret::symbol())
-        return make_shared<stealth_secret>();
-    if (symbol == stealth_shared::symbol())
-        return make_shared<stealth_shared>();
-    if (symbol == tx_decode::symbol())
-        return make_shared<tx_decode>();
-    if (symbol == validate_tx::symbol())
-        return make_shared<validate_tx>();
+    static const unordered_map<string, command_factory> originals
+    {
+        factory<help>(),
+        factory<send_tx>(),
+        factory<settings>(),
+        factory<fetch_history>(),
+        factory<stealth_decode>(),
+        factory<stealth_encode>(),
+        factory<stealth_public>(),
+        factory<stealth_secret>(),
+        factory<stealth_shared>(),
+        factory<tx_decode>(),
+        factory<validate_tx>()
+    };
+
+    const auto it = originals.find(symbol);
+    if (it != originals.end())
+        return it->second();
 
     return find_extension(symbol);
 }
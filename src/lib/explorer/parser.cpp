@@ -20,8 +20,10 @@
  */
 #include <metaverse/explorer/parser.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <vector>
 #include <boost/program_options.hpp>
 #include <metaverse/explorer/command.hpp>
 #include <metaverse/explorer/define.hpp>
@@ -79,6 +81,95 @@ void parser::load_command_variables(variables_map& variables,
         instance_.load_fallbacks(input, variables);
 }
 
+// The parsed options are those the command line parser would produce for the
+// equivalent '--key value' tokens, so store applies the same semantics.
+void parser::load_json_variables(variables_map& variables,
+    std::istream& input, const Json::Value& options,
+    const std::vector<std::string>& arguments)
+{
+    const auto description = load_options();
+    const auto positional = load_arguments();
+    po::parsed_options parsed(&description);
+
+    const auto add_option = [&](const option_description& option,
+        const std::string& key, const Json::Value& value)
+    {
+        po::basic_option<char> bound;
+        bound.string_key = option.key(key);
+        bound.original_tokens.push_back("--" + key);
+
+        // A switch takes no value, a missing value is left for store.
+        if (!value.empty() && option.semantic()->max_tokens() > 0)
+        {
+            bound.value.push_back(value.asString());
+            bound.original_tokens.push_back(bound.value.back());
+        }
+
+        if (bound.value.size() < option.semantic()->min_tokens())
+            throw po::invalid_command_line_syntax(
+                po::invalid_command_line_syntax::missing_parameter, key);
+
+        parsed.options.push_back(std::move(bound));
+    };
+
+    if (options.isObject())
+    {
+        for (const auto& key: options.getMemberNames())
+        {
+            // Prefix matching follows the command line parser's guessing.
+            const auto option = description.find_nothrow(key, true);
+            if (option == nullptr)
+                throw po::unknown_option(key);
+
+            const auto& value = options[key];
+            if (!value.isArray())
+            {
+                add_option(*option, key, value);
+                continue;
+            }
+
+            for (const auto& member: value)
+                add_option(*option, key, member);
+        }
+    }
+
+    const auto is_option = [](const std::string& token)
+    {
+        return token.size() > 1 && token.front() == '-';
+    };
+
+    // Clients such as mvs-cli send a command line as the positional params.
+    if (std::any_of(arguments.begin(), arguments.end(), is_option))
+    {
+        const auto command_line = po::command_line_parser(arguments)
+            .options(description).positional(positional).run();
+        parsed.options.insert(parsed.options.end(),
+            command_line.options.begin(), command_line.options.end());
+    }
+    else
+    {
+        if (arguments.size() > positional.max_total_count())
+            throw po::too_many_positional_options_error();
+
+        for (size_t position = 0; position < arguments.size(); ++position)
+        {
+            po::basic_option<char> bound;
+            bound.string_key = positional.name_for_position(position);
+            bound.position_key = static_cast<int>(position);
+            bound.value.push_back(arguments[position]);
+            bound.original_tokens.push_back(arguments[position]);
+            parsed.options.push_back(std::move(bound));
+        }
+    }
+
+    store(parsed, variables);
+
+    // Don't load rest if help is specified.
+    // For variable with stdin or file fallback load the input stream.
+    if (!get_option(variables, BX_HELP_VARIABLE))
+        instance_.load_fallbacks(input, variables);
+}
+
 bool parser::parse(std::string& out_error, std::istream& input,
     int argc, const char* argv[])
 {
@@ -131,5 +222,52 @@ bool parser::parse(std::string& out_error, std::istream& input,
     return true;
 }
 
+bool parser::parse(std::string& out_error, std::istream& input,
+    const Json::Value& options, const std::vector<std::string>& arguments)
+{
+    try
+    {
+        variables_map variables;
+        load_json_variables(variables, input, options, arguments);
+
+        // Don't load rest if help is specified.
+        if (!get_option(variables, BX_HELP_VARIABLE))
+        {
+            // Extensions take no environment or configuration file values,
+            // the remaining commands keep the command line precedence.
+            if (!instance_.category(ctgy_extension))
+            {
+                load_environment_variables(variables,
+                    BX_ENVIRONMENT_VARIABLE_PREFIX);
+                load_configuration_variables(variables, BX_CONFIG_VARIABLE);
+            }
+
+            // Set variable defaults, send notifications and update bound vars.
+            notify(variables);
+
+            // Set the instance defaults from config values.
+            instance_.set_defaults_from_config(variables);
+        } else {
+            help_ = true;
+        }
+    }
+    catch (const po::invalid_option_value& e)
+    {
+        // See above, boost can throw 'std::out_of_range' from e.what().
+        po::invalid_option_value ex{e};
+        ex.set_original_token("OPTION");
+        out_error = ex.what();
+        return false;
+    }
+    catch (const po::error& e)
+    {
+        // This is obtained from boost, which circumvents our localization.
+        out_error = e.what();
+        return false;
+    }
+
+    return true;
+}
+
 } // namespace explorer
 } // namespace libbitcoin
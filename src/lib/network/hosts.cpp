@@ -45,17 +45,77 @@ hosts::hosts(threadpool& pool, const settings& settings)
 //	buffer_.reserve(std::max(settings.host_pool_capacity, 1u));
 }
 
-// private
-hosts::iterator hosts::find(const address& host)
+// list
+// ----------------------------------------------------------------------------
+
+bool hosts::list::insert(const address& host)
+{
+    if (!index_.emplace(host, hosts_.size()).second)
+        return false;
+
+    hosts_.push_back(host);
+    return true;
+}
+
+// The last entry takes the position of the erased one.
+bool hosts::list::erase(const address& host)
 {
-    const auto found = [&host](const address& entry)
+    const auto it = index_.find(host);
+    if (it == index_.end())
+        return false;
+
+    const auto position = it->second;
+    index_.erase(it);
+
+    if (position != hosts_.size() - 1)
     {
-        return entry.port == host.port && entry.ip == host.ip;
-    };
-    return buffer_.find(host);
-//    return std::find_if(buffer_.begin(), buffer_.end(), found);
+        hosts_[position] = hosts_.back();
+        index_[hosts_[position]] = position;
+    }
+
+    hosts_.pop_back();
+    return true;
+}
+
+bool hosts::list::contains(const address& host) const
+{
+    return index_.find(host) != index_.end();
+}
+
+const hosts::address& hosts::list::operator[](size_t index) const
+{
+    return hosts_[index];
+}
+
+size_t hosts::list::size() const
+{
+    return hosts_.size();
+}
+
+bool hosts::list::empty() const
+{
+    return hosts_.empty();
+}
+
+void hosts::list::clear()
+{
+    hosts_.clear();
+    index_.clear();
+}
+
+hosts::list::const_iterator hosts::list::begin() const
+{
+    return hosts_.begin();
+}
+
+hosts::list::const_iterator hosts::list::end() const
+{
+    return hosts_.end();
 }
 
+// hosts
+// ----------------------------------------------------------------------------
+
 size_t hosts::count() const
 {
     ///////////////////////////////////////////////////////////////////////////
@@ -68,62 +128,70 @@ size_t hosts::count() const
 
 static std::atomic<uint64_t> fetch_times{0};
 
-static std::vector<config::authority> hosts_{config::authority("198.199.84.199:5252")};
+// Random draws before falling back to a scan of the buffer.
+static constexpr size_t select_attempts = 16;
+
+// Draw at random and retry on an excluded address, which is expected
+// constant time while the excluded are a small part of the buffer.
+bool hosts::select(address& out, const list& buffer,
+    const config::authority::list& excluded_list) const
+{
+    if (buffer.empty())
+        return false;
+
+    address::list excluded;
+    excluded.reserve(excluded_list.size());
+    for (const auto& authority: excluded_list)
+        excluded.push_back(authority.to_network_address());
+
+    const auto is_excluded = [&excluded](const address& host)
+    {
+        return std::any_of(excluded.begin(), excluded.end(),
+            [&host](const address& entry)
+            {
+                return address_equal()(entry, host);
+            });
+    };
+
+    for (size_t attempt = 0; attempt < select_attempts; ++attempt)
+    {
+        const auto& host = buffer[pseudo_random() % buffer.size()];
+        if (!is_excluded(host))
+        {
+            out = host;
+            return true;
+        }
+    }
+
+    // Mostly excluded, pick uniformly from the remainder in one pass.
+    size_t candidates = 0;
+    for (const auto& host: buffer)
+        if (!is_excluded(host) && pseudo_random() % ++candidates == 0)
+            out = host;
+
+    return candidates != 0;
+}
 
 code hosts::fetch(address& out, const config::authority::list& excluded_list)
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-	shared_lock lock(mutex_);
-	fetch_times++;
-	config::authority::list addresses;
-	list* buffer=nullptr;
-	{
-
-		if (stopped_)
-		{
-			return error::service_stopped;
-		}
+    shared_lock lock(mutex_);
+    fetch_times++;
 
-		if (fetch_times % 5 == 4 && !inactive_.empty())
-			buffer = &inactive_;
-		else
-			buffer = &buffer_;
-	}
+    if (stopped_)
+        return error::service_stopped;
 
-	for(auto entry: *buffer)
-	{
-		auto iter = std::find(excluded_list.begin(), excluded_list.end(), config::authority(entry) );
-		if(iter == excluded_list.end())
-		{
-			addresses.push_back(config::authority(entry));
-		}
-	}
+    const auto& buffer = fetch_times % 5 == 4 && !inactive_.empty() ?
+        inactive_ : buffer_;
 
-	if (addresses.empty()) {
-		if (inactive_.empty()) {
-			return error::not_found;
-		}
-		const auto index = static_cast<size_t>(pseudo_random() % inactive_.size());
-
-		size_t i = 0;
-		for (const auto& entry : inactive_)
-		{
-			if (i == index) {
-				out = entry;
-				break;
-			}
-			i++;
-		}
-
-		return error::success;
-	}
+    if (select(out, buffer, excluded_list))
+        return error::success;
 
-	const auto index = static_cast<size_t>(pseudo_random() % addresses.size());
-	out = addresses[index].to_network_address();
+    if (inactive_.empty())
+        return error::not_found;
 
-//	const auto index = static_cast<size_t>(pseudo_random() % hosts_.size());
-//	out = hosts_[index].to_network_address();
+    out = inactive_[pseudo_random() % inactive_.size()];
     return error::success;
     ///////////////////////////////////////////////////////////////////////////
 }
@@ -133,13 +201,80 @@ hosts::address::list hosts::copy()
 	address::list copy;
 
 	shared_lock lock{mutex_};
-	copy.reserve(buffer_.size());
-	for (auto& h:buffer_) {
-		copy.push_back(h);
-	}
+	copy.assign(buffer_.begin(), buffer_.end());
 	return copy;
 }
 
+// The hosts file is the magic, the format version, the address count and then
+// each address in wire format with its timestamp.
+static const std::string hosts_file_magic("mvs.hosts");
+static constexpr uint32_t hosts_file_version = 1;
+static constexpr uint32_t hosts_file_address_version = 0;
+
+// private
+void hosts::load(std::istream& file)
+{
+    const auto add = [this](const address& host)
+    {
+        if (host.port == 0)
+            return;
+
+        if (host.is_routable())
+            buffer_.insert(host);
+        else
+            log::debug(LOG_NETWORK) << "host start is not routable,"
+                << config::authority{host};
+    };
+
+    std::string magic(hosts_file_magic.size(), '\0');
+    file.read(&magic[0], magic.size());
+
+    if (file && magic == hosts_file_magic)
+    {
+        istream_reader source(file);
+        if (source.read_4_bytes_little_endian() != hosts_file_version)
+            return;
+
+        const auto count = source.read_4_bytes_little_endian();
+        for (uint32_t index = 0; index < count && source; ++index)
+        {
+            const auto host = address::factory_from_data(
+                hosts_file_address_version, source, true);
+
+            if (source)
+                add(host);
+        }
+
+        return;
+    }
+
+    // A hosts file written before the binary format.
+    file.clear();
+    file.seekg(0);
+    std::string line;
+
+    while (std::getline(file, line))
+        add(config::authority(line).to_network_address());
+}
+
+// private
+void hosts::save(std::ostream& file, bool with_inactive) const
+{
+    const auto count = buffer_.size() + (with_inactive ? inactive_.size() : 0);
+
+    file.write(hosts_file_magic.data(), hosts_file_magic.size());
+    ostream_writer sink(file);
+    sink.write_4_bytes_little_endian(hosts_file_version);
+    sink.write_4_bytes_little_endian(static_cast<uint32_t>(count));
+
+    for (const auto& entry: buffer_)
+        entry.to_data(hosts_file_address_version, sink, true);
+
+    if (with_inactive)
+        for (const auto& entry: inactive_)
+            entry.to_data(hosts_file_address_version, sink, true);
+}
+
 void hosts::handle_timer(const code& ec)
 {
 	if (ec.value() != error::success){
@@ -155,17 +290,14 @@ void hosts::handle_timer(const code& ec)
     }
 
     mutex_.unlock_upgrade_and_lock();
-	bc::ofstream file(file_path_.string());
+	bc::ofstream file(file_path_.string(), std::ios::binary);
 	const auto file_error = file.bad();
 
 	if (!file_error)
 	{
 		log::debug(LOG_NETWORK) << "sync hosts to file(" << file_path_.string() << "), active hosts size is "
 				<< buffer_.size() << " hosts found, inactive hosts size is " << inactive_.size();
-		for (const auto& entry: buffer_)
-			file << config::authority(entry) << std::endl;
-		for (const auto& entry: inactive_)
-			file << config::authority(entry) << std::endl;
+		save(file, true);
 	}
 	else
 	{
@@ -199,31 +331,11 @@ code hosts::start()
     snap_timer_ = std::make_shared<deadline>(pool_, asio::seconds(60));
     snap_timer_->start(std::bind(&hosts::handle_timer, shared_from_this(), std::placeholders::_1));
     stopped_ = false;
-    bc::ifstream file(file_path_.string());
+    bc::ifstream file(file_path_.string(), std::ios::binary);
     const auto file_error = file.bad();
 
     if (!file_error)
-    {
-        std::string line;
-
-        while (std::getline(file, line))
-        {
-            config::authority host(line);
-
-            if (host.port() != 0)
-            {
-            	auto network_address = host.to_network_address();
-            	if(network_address.is_routable())
-				{
-					buffer_.insert(network_address);
-				}
-				else
-				{
-					log::debug(LOG_NETWORK) << "host start is not routable," << config::authority{network_address};
-				}
-            }
-        }
-    }
+        load(file);
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
@@ -259,14 +371,12 @@ code hosts::stop()
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     snap_timer_->stop();
     stopped_ = true;
-    bc::ofstream file(file_path_.string());
+    bc::ofstream file(file_path_.string(), std::ios::binary);
     const auto file_error = file.bad();
 
     if (!file_error)
     {
-        for (const auto& entry: buffer_)
-            file << config::authority(entry) << std::endl;
-
+        save(file, false);
         buffer_.clear();
     }
 
@@ -345,13 +455,11 @@ code hosts::remove(const address& host)
         return error::service_stopped;
     }
 
-    auto it = find(host);
-
-    if (it != buffer_.end())
+    if (buffer_.contains(host))
     {
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-        buffer_.erase(it);
+        buffer_.erase(host);
 
         mutex_.unlock();
         //---------------------------------------------------------------------
@@ -359,10 +467,7 @@ code hosts::remove(const address& host)
     }
 
     mutex_.unlock_upgrade_and_lock();
-    auto iter = inactive_.find(host);
-	if (iter == inactive_.end()) {
-		inactive_.insert(host);
-	}
+	inactive_.insert(host);
 	mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
@@ -388,15 +493,12 @@ code hosts::store(const address& host)
         return error::service_stopped;
     }
 
-    if (find(host) == buffer_.end())
+    if (!buffer_.contains(host))
     {
         mutex_.unlock_upgrade_and_lock();
         //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
         buffer_.insert(host);
-        auto iter = inactive_.find(host);
-        if (iter != inactive_.end()){
-        	inactive_.erase(iter);
-        }
+        inactive_.erase(host);
 
         mutex_.unlock();
         //---------------------------------------------------------------------
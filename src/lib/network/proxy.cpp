@@ -80,9 +80,53 @@ std::shared_ptr<traffic> traffic::instance_ = nullptr;
 
 #define NAME "proxy"
 
+// Unwritten bytes above which the channel reports congestion.
+static constexpr size_t send_congestion_bytes = 8 * 1024 * 1024;
+
+// Unwritten bytes above which the peer is considered not to be reading.
+static constexpr size_t send_limit_bytes = 256 * 1024 * 1024;
+
 using namespace message;
 using namespace std::placeholders;
 
+static metrics::counter_family& received_messages()
+{
+    static auto& family = metrics::counter("mvs_p2p_received_messages_total",
+        "Peer messages received by command.", "command");
+    return family;
+}
+
+static metrics::counter_family& received_bytes()
+{
+    static auto& family = metrics::counter("mvs_p2p_received_bytes_total",
+        "Peer message bytes received by command, including headings.",
+        "command");
+    return family;
+}
+
+static metrics::counter_family& sent_messages()
+{
+    static auto& family = metrics::counter("mvs_p2p_sent_messages_total",
+        "Peer messages sent by command.", "command");
+    return family;
+}
+
+static metrics::counter_family& sent_bytes()
+{
+    static auto& family = metrics::counter("mvs_p2p_sent_bytes_total",
+        "Peer message bytes sent by command, including headings.", "command");
+    return family;
+}
+
+// A peer can send any command name and each label is kept for the life of the
+// process, so commands outside the known message set share one label.
+static std::string command_label(const std::string& command)
+{
+    heading head;
+    head.command = command;
+    return head.type() == message_type::unknown ? "other" : command;
+}
+
 proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     uint32_t protocol_version)
   : protocol_magic_(protocol_magic),
@@ -96,7 +140,8 @@ proxy::proxy(threadpool& pool, socket::ptr socket, uint32_t protocol_magic,
     peer_protocol_version_(message::version::level::maximum),
     message_subscriber_(pool),
     stop_subscriber_(std::make_shared<stop_subscriber>(pool, NAME)),
-    has_sent_{true},
+    pending_bytes_(0),
+    sending_(false),
     misbehaving_{0}
 {
 }
@@ -114,6 +159,16 @@ const config::authority& proxy::authority() const
     return authority_;
 }
 
+uint32_t proxy::protocol_version() const
+{
+    return protocol_version_;
+}
+
+uint32_t proxy::protocol_magic() const
+{
+    return protocol_magic_;
+}
+
 message::version proxy::version() const
 {
     const auto version = peer_version_message_.load();
@@ -276,7 +331,12 @@ void proxy::handle_read_payload(const boost_code& ec, size_t payload_size,
         stop(error::bad_stream);
         return;
     }
-    
+
+    const auto label = command_label(head.command);
+    received_messages().get(label).increment();
+    received_bytes().get(label).increment(heading_buffer_.size() +
+        payload_size);
+
     ///////////////////////////////////////////////////////////////////////////
     // TODO: we aren't getting a stream benefit if we read the full payload
     // before parsing the message. Should just make this a message parse.
@@ -337,111 +397,147 @@ void proxy::do_send(const std::string& command, const_buffer buffer,
         return;
     }
 
-    if (command == "headers") {
-        log::trace(LOG_NETWORK) << "";
-    }
+    const auto label = command_label(command);
+    sent_messages().get(label).increment();
+    sent_bytes().get(label).increment(buffer.size());
 
     //thin log network
     log::trace(LOG_NETWORK)
         << "Sending " << command << " to [" << authority() << "] ("
         << buffer.size() << " bytes)";
 
-    // Critical Section (protect socket)
+    send_batch_ptr batch;
+    size_t pending_bytes;
+
     ///////////////////////////////////////////////////////////////////////////
-    // The socket is locked until async_write returns.
-#define QUEUE_REQUEST
-#ifdef QUEUE_REQUEST
-    bool is_ok_to_send{false};
-    uint32_t outbound_size{0};
-    request_callback h{nullptr};
+    // Critical Section
     {
-        auto pThis = shared_from_this();
-        auto f = [this, pThis, buffer, handler](){
-            if (stopped())
-            {
-                handler(error::channel_stopped);
-                return;
-            }
-            const auto socket = socket_->get_socket();
-            auto& native_socket = socket->get();
-            async_write(native_socket, buffer,
-                    std::bind(&proxy::handle_send,
-                            shared_from_this(), _1, buffer, handler));
-        };
-        const auto socket = socket_->get_socket();
-        outbound_size = outbound_queue_.size();
-        bool is_empty{outbound_queue_.empty()};
-        bool in_sending{!has_sent_.load()};
-        is_ok_to_send = (is_empty && !in_sending);
-        if (is_ok_to_send)
+        unique_lock lock(send_mutex_);
+        pending_sends_.push_back({ buffer, handler });
+        pending_bytes_ += buffer.size();
+        pending_bytes = pending_bytes_;
+
+        // Start a write unless one is in flight, its completion picks up
+        // everything queued meanwhile.
+        if (!sending_)
         {
-            h = std::move(f);
-            has_sent_.store(false);
-        }
-        else{
-            outbound_queue_.push(std::move(f));
+            sending_ = true;
+            batch = std::make_shared<send_batch>();
+            batch->swap(pending_sends_);
         }
     }
+    ///////////////////////////////////////////////////////////////////////////
 
-    if (outbound_size > 500) {
+    // A peer this far behind is not reading.
+    if (pending_bytes > send_limit_bytes)
+    {
+        log::debug(LOG_NETWORK)
+            << "Send queue of [" << authority() << "] exceeds "
+            << send_limit_bytes << " bytes.";
         stop(error::size_limits);
         return;
     }
 
-    if (is_ok_to_send)
+    if (batch)
+        write(batch);
+}
+
+// Write all queued messages with one gathering write.
+void proxy::write(send_batch_ptr batch)
+{
+    if (stopped())
     {
-        h();
+        handle_send(asio::error::operation_aborted, batch);
+        return;
     }
-#else
-    const auto socket = socket_->get_socket();
 
-    // The shared buffer is kept in scope until the handler is invoked.
-    using namespace boost::asio;
-    async_write(socket->get(), buffer,
+    std::vector<asio::const_buffer> buffers;
+    buffers.reserve(batch->size());
+
+    // The shared buffers are kept in scope by the batch until the handler.
+    for (const auto& send: *batch)
+        buffers.push_back(*send.buffer.begin());
+
+    const auto socket = socket_->get_socket();
+    async_write(socket->get(), buffers,
         std::bind(&proxy::handle_send,
-            shared_from_this(), _1, buffer, handler));
-#endif
-    // The shared buffer is kept in scope until the handler is invoked.
-    ///////////////////////////////////////////////////////////////////////////
+            shared_from_this(), _1, batch));
 }
 
-void proxy::handle_send(const boost_code& ec, const_buffer buffer,
-    result_handler handler)
+void proxy::handle_send(const boost_code& ec, send_batch_ptr batch)
 {
     const auto error = code(error::boost_to_error_code(ec));
+    size_t batch_bytes = 0;
+
+    for (const auto& send: *batch)
+        batch_bytes += send.buffer.size();
 
     if (error)
         log::trace(LOG_NETWORK)
-            << "Failure sending " << buffer.size() << " byte message to ["
-            << authority() << "] " << error.message();
-    else{
+            << "Failure sending " << batch->size() << " messages ("
+            << batch_bytes << " bytes) to [" << authority() << "] "
+            << error.message();
 #ifndef NDEBUG
-        traffic::instance().tx(buffer.size());
+    else
+        traffic::instance().tx(batch_bytes);
 #endif
-    }
 
-    handler(error);
-#ifdef QUEUE_REQUEST
-    if(error){
-        const auto socket = socket_->get_socket();
-        std::queue<request_callback>{}.swap(outbound_queue_);
-        return;
+    for (const auto& send: *batch)
+        send.handler(error);
+
+    send_batch_ptr next;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        unique_lock lock(send_mutex_);
+        pending_bytes_ -= batch_bytes;
+
+        if (error || pending_sends_.empty())
+        {
+            sending_ = false;
+        }
+        else
+        {
+            next = std::make_shared<send_batch>();
+            next->swap(pending_sends_);
+        }
     }
+    ///////////////////////////////////////////////////////////////////////////
 
-    has_sent_.store(true);
+    if (error)
+        clear_sends(error);
+    else if (next)
+        write(next);
+}
+
+// Fail the queued sends, a write in flight completes on its own.
+void proxy::clear_sends(const code& ec)
+{
+    send_batch cleared;
 
-    request_callback h{nullptr};
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
     {
-        const auto socket = socket_->get_socket();
-        if(outbound_queue_.empty())
-            return;
-        log::trace(LOG_NETWORK) << "channel:" << reinterpret_cast<int64_t>(this) << " outbound size," << outbound_queue_.size();
-        h = std::move(outbound_queue_.front());
-        outbound_queue_.pop();
-        has_sent_.store(false);
+        unique_lock lock(send_mutex_);
+        cleared.swap(pending_sends_);
+
+        for (const auto& send: cleared)
+            pending_bytes_ -= send.buffer.size();
     }
-    h();
-#endif
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& send: cleared)
+        send.handler(ec);
+}
+
+bool proxy::congested() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(send_mutex_);
+    return pending_bytes_ > send_congestion_bytes;
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 // Stop sequence.
@@ -467,10 +563,7 @@ void proxy::stop(const code& ec)
 
     // Give channel opportunity to terminate timers.
     handle_stopping();
-    {
-        const auto socket = socket_->get_socket();
-        std::queue<request_callback>{}.swap(outbound_queue_);
-    }
+    clear_sends(error::channel_stopped);
 
     // The socket_ is internally guarded against concurrent use.
     socket_->close();
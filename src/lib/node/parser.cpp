@@ -142,7 +142,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -276,6 +276,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.database.stealth_start_height),
         "The lower limit of stealth indexing, defaults to 500000."
     )
+    (
+        "database.write_threads",
+        value<uint32_t>(&configured.database.write_threads),
+        "The number of threads writing a block to the databases in parallel, zero writes serially, defaults to 4."
+    )
     (
         "database.directory",
         value<path>(&configured.database.directory),
@@ -298,6 +303,21 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.transaction_pool_consistency),
         "Enforce consistency between the pool and the blockchain, defaults to false."
     )
+    (
+        "blockchain.transaction_pool_file",
+        value<path>(&configured.chain.transaction_pool_file),
+        "The transaction pool snapshot file path, empty to disable, defaults to 'mempool.cache'."
+    )
+    (
+        "blockchain.transaction_pool_snapshot_minutes",
+        value<uint32_t>(&configured.chain.transaction_pool_snapshot_minutes),
+        "The interval between transaction pool snapshots, zero saves only on stop, defaults to 10."
+    )
+    (
+        "blockchain.script_cache_capacity",
+        value<uint32_t>(&configured.chain.script_cache_capacity),
+        "The maximum number of verified input scripts remembered from the pool, defaults to 100000."
+    )
     (
         "blockchain.use_testnet_rules",
         value<bool>(&configured.chain.use_testnet_rules),
@@ -130,6 +130,15 @@ bool protocol_block_sync::handle_receive(const code& ec, block_ptr message,
     // Add the block to the blockchain store.
     reservation_->import(message);
 
+    if (reservation_->toggle_rejected())
+    {
+        log::debug(LOG_NODE)
+            << "Stopping slot (" << reservation_->slot()
+            << ") after a rejected block.";
+        complete(error::channel_stopped);
+        return false;
+    }
+
     if (reservation_->toggle_partitioned())
     {
         log::trace(LOG_NODE)
@@ -178,6 +187,15 @@ void protocol_block_sync::handle_event(const code& ec, event_handler complete)
         return;
     }
 
+    if (reservation_->toggle_rejected())
+    {
+        log::debug(LOG_NODE)
+            << "Stopping slot (" << reservation_->slot()
+            << ") after a rejected block.";
+        complete(error::channel_stopped);
+        return;
+    }
+
     if (reservation_->expired())
     {
         log::trace(LOG_NODE)
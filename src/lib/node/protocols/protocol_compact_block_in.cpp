@@ -0,0 +1,365 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/protocols/protocol_compact_block_in.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/network.hpp>
+#include <metaverse/node/utility/short_id_hasher.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+#define NAME "compact_block"
+#define CLASS protocol_compact_block_in
+
+using namespace bc::blockchain;
+using namespace bc::message;
+using namespace bc::network;
+using namespace std::placeholders;
+
+// The version of compact block encoding we understand (no witness).
+static constexpr uint64_t compact_version = 1;
+
+// Blocks awaiting missing transactions, the oldest is dropped beyond this.
+static constexpr size_t maximum_pending = 8;
+
+// The smallest serialized transaction: version, empty input and output
+// counts and lock time. A block cannot hold more than its size over this.
+static constexpr size_t minimum_transaction_size = 10;
+static constexpr size_t maximum_transactions = max_block_size /
+    minimum_transaction_size;
+
+protocol_compact_block_in::protocol_compact_block_in(p2p& network,
+    channel::ptr channel, block_chain& blockchain, transaction_pool& pool)
+  : protocol_events(network, channel, NAME),
+    blockchain_(blockchain),
+    pool_(pool),
+    compact_from_peer_(
+        network.network_settings().protocol >= version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
+    CONSTRUCT_TRACK(protocol_compact_block_in)
+{
+}
+
+protocol_compact_block_in::ptr protocol_compact_block_in::do_subscribe()
+{
+    if (compact_from_peer_)
+    {
+        SUBSCRIBE2(compact_block, handle_receive_compact_block, _1, _2);
+        SUBSCRIBE2(block_transactions, handle_receive_block_transactions,
+            _1, _2);
+    }
+
+    protocol_events::start(BIND1(handle_stop, _1));
+    return std::dynamic_pointer_cast<protocol_compact_block_in>(protocol::shared_from_this());
+}
+
+// Start.
+//-----------------------------------------------------------------------------
+
+void protocol_compact_block_in::start()
+{
+    if (!compact_from_peer_)
+        return;
+
+    // Ask the peer to push new blocks to us as compact blocks, unannounced.
+    send_compact_blocks request;
+    request.high_bandwidth_mode = true;
+    request.version = compact_version;
+    SEND2(request, handle_send, _1, request.command);
+}
+
+// Receive compact_block.
+//-----------------------------------------------------------------------------
+
+bool protocol_compact_block_in::handle_receive_compact_block(const code& ec,
+    compact_block_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting compact block from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // The count sizes the partial block, so it is bounded before anything
+    // is allocated for it.
+    const auto count = message->short_ids.size() +
+        message->transactions.size();
+
+    if (count > maximum_transactions)
+    {
+        log::debug(LOG_NODE)
+            << "Oversized compact block (" << count << ") txs from ["
+            << authority() << "]";
+        stop(error::bad_stream);
+        return false;
+    }
+
+    pool_.fetch(BIND3(handle_fetch_pool, _1, _2, message));
+    return true;
+}
+
+void protocol_compact_block_in::handle_fetch_pool(const code& ec,
+    const transaction_ptr_list& pool, compact_block_ptr message)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    const auto hash = message->header.hash();
+
+    if (ec)
+    {
+        log::debug(LOG_NODE)
+            << "Failure reading pool for compact block ["
+            << encode_hash(hash) << "] " << ec.message();
+        send_get_block(hash);
+        return;
+    }
+
+    const auto count = message->short_ids.size() +
+        message->transactions.size();
+
+    partial_block block;
+    block.header = message->header;
+    block.transactions.resize(count);
+    std::vector<bool> filled(count, false);
+
+    // Prefilled indexes are differentially encoded, each relative to the
+    // position after the previous one.
+    uint64_t position = 0;
+    for (const auto& prefilled: message->transactions)
+    {
+        if (prefilled.index >= count - position)
+        {
+            log::debug(LOG_NODE)
+                << "Invalid prefilled index in compact block from ["
+                << authority() << "]";
+            stop(error::bad_stream);
+            return;
+        }
+
+        position += prefilled.index;
+        block.transactions[position] = prefilled.transaction;
+        filled[position++] = true;
+    }
+
+    // Pool transactions with colliding short ids are ambiguous, so they are
+    // left to be requested.
+    const short_id_hasher hasher(message->header, message->nonce);
+    std::unordered_map<uint64_t, transaction_ptr> pool_ids;
+    pool_ids.reserve(pool.size());
+
+    for (const auto& tx: pool)
+    {
+        const auto result = pool_ids.emplace(hasher(tx->hash()), tx);
+        if (!result.second)
+            result.first->second.reset();
+    }
+
+    auto id = message->short_ids.begin();
+    for (size_t index = 0; index < count; ++index)
+    {
+        if (filled[index])
+            continue;
+
+        const auto found = pool_ids.find(short_id_hasher::to_number(*id++));
+        if (found != pool_ids.end() && found->second)
+            block.transactions[index] = *found->second;
+        else
+            block.missing.push_back(index);
+    }
+
+    if (block.missing.empty())
+    {
+        complete(std::move(block));
+        return;
+    }
+
+    get_block_transactions request;
+    request.block_hash = hash;
+    request.indexes.reserve(block.missing.size());
+
+    uint64_t next = 0;
+    for (const auto index: block.missing)
+    {
+        request.indexes.push_back(index - next);
+        next = index + 1;
+    }
+
+    log::trace(LOG_NODE)
+        << "Compact block [" << encode_hash(hash) << "] from ["
+        << authority() << "] missing " << block.missing.size() << " of "
+        << count << " transactions.";
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    if (pending_.size() >= maximum_pending)
+        pending_.erase(pending_.begin());
+
+    pending_[hash] = std::move(block);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    SEND2(request, handle_send, _1, request.command);
+}
+
+// Receive block_transactions.
+//-----------------------------------------------------------------------------
+
+bool protocol_compact_block_in::handle_receive_block_transactions(
+    const code& ec, block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting block transactions from [" << authority()
+            << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    partial_block block;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock();
+
+    const auto it = pending_.find(message->block_hash);
+    const auto found = (it != pending_.end());
+
+    if (found)
+    {
+        block = std::move(it->second);
+        pending_.erase(it);
+    }
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!found)
+    {
+        log::trace(LOG_NODE)
+            << "Unrequested block transactions from [" << authority() << "]";
+        return true;
+    }
+
+    if (message->transactions.size() != block.missing.size())
+    {
+        log::debug(LOG_NODE)
+            << "Incomplete block transactions from [" << authority() << "]";
+        send_get_block(message->block_hash);
+        return true;
+    }
+
+    for (size_t index = 0; index < block.missing.size(); ++index)
+        block.transactions[block.missing[index]] =
+            message->transactions[index];
+
+    complete(std::move(block));
+    return true;
+}
+
+// Reconstruction.
+//-----------------------------------------------------------------------------
+
+void protocol_compact_block_in::complete(partial_block&& block)
+{
+    const auto hash = block.header.hash();
+
+    // A short id collision yields the wrong transaction, which the merkle
+    // root exposes. The full block is then requested instead.
+    if (chain::block::generate_merkle_root(block.transactions) !=
+        block.header.merkle)
+    {
+        log::debug(LOG_NODE)
+            << "Compact block [" << encode_hash(hash) << "] from ["
+            << authority() << "] did not reconstruct, requesting block.";
+        send_get_block(hash);
+        return;
+    }
+
+    block.header.transaction_count = block.transactions.size();
+    const auto message = std::make_shared<block_message>(
+        std::move(block.header), std::move(block.transactions));
+
+    // The block is then treated as if it arrived in full from this peer.
+    message->set_originator(nonce());
+    blockchain_.store(message, BIND2(handle_store_block, _1, message));
+}
+
+void protocol_compact_block_in::send_get_block(const hash_digest& hash)
+{
+    const get_data request{ { inventory::type_id::block, hash } };
+    SEND2(request, handle_send, _1, request.command);
+}
+
+void protocol_compact_block_in::handle_store_block(const code& ec,
+    block_ptr message)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    // Ignore the block that we already have, a common result.
+    if (ec == (code)error::duplicate || ec == (code)error::fetch_more_block)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block [" << encode_hash(message->header.hash())
+            << "] from [" << authority() << "] " << ec.message();
+        return;
+    }
+
+    if (ec)
+    {
+        log::warning(LOG_NODE)
+            << "Error storing compact block from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return;
+    }
+
+    log::trace(LOG_NODE)
+        << "Potential compact block from [" << authority() << "].";
+}
+
+void protocol_compact_block_in::handle_stop(const code&)
+{
+    log::trace(LOG_NETWORK)
+        << "Stopped compact_block_in protocol";
+}
+
+} // namespace node
+} // namespace libbitcoin
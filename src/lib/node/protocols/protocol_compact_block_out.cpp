@@ -0,0 +1,316 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/protocols/protocol_compact_block_out.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <metaverse/blockchain.hpp>
+#include <metaverse/network.hpp>
+#include <metaverse/node/utility/short_id_hasher.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+#define NAME "compact_block"
+#define CLASS protocol_compact_block_out
+
+using namespace bc::blockchain;
+using namespace bc::message;
+using namespace bc::network;
+using namespace std::placeholders;
+
+// The version of compact block encoding we produce (no witness).
+static constexpr uint64_t compact_version = 1;
+
+protocol_compact_block_out::protocol_compact_block_out(p2p& network,
+    channel::ptr channel, block_chain& blockchain)
+  : protocol_events(network, channel, NAME),
+    blockchain_(blockchain),
+    compact_to_peer_(
+        network.network_settings().protocol >= version::level::bip152 &&
+        peer_version().value >= version::level::bip152),
+    high_bandwidth_(false),
+    CONSTRUCT_TRACK(protocol_compact_block_out)
+{
+}
+
+protocol_compact_block_out::ptr protocol_compact_block_out::do_subscribe()
+{
+    if (compact_to_peer_)
+    {
+        SUBSCRIBE2(send_compact_blocks, handle_receive_send_compact_blocks,
+            _1, _2);
+        SUBSCRIBE2(get_block_transactions,
+            handle_receive_get_block_transactions, _1, _2);
+        SUBSCRIBE2(get_data, handle_receive_get_data, _1, _2);
+    }
+
+    protocol_events::start(BIND1(handle_stop, _1));
+    return std::dynamic_pointer_cast<protocol_compact_block_out>(protocol::shared_from_this());
+}
+
+// Start.
+//-----------------------------------------------------------------------------
+
+void protocol_compact_block_out::start()
+{
+    if (!compact_to_peer_)
+        return;
+
+    // Subscribe to block acceptance notifications to push new blocks.
+    blockchain_.subscribe_reorganize(
+        BIND4(handle_reorganized, _1, _2, _3, _4));
+    if (channel_stopped()) {
+        blockchain_.fired();
+    }
+}
+
+// Receive send_compact_blocks.
+//-----------------------------------------------------------------------------
+
+bool protocol_compact_block_out::handle_receive_send_compact_blocks(
+    const code& ec, send_compact_blocks_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting " << message->command << " from ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // The peer may send this again to change modes, other versions are
+    // announcements of encodings we do not produce.
+    if (message->version == compact_version)
+        high_bandwidth_.store(message->high_bandwidth_mode);
+
+    return true;
+}
+
+// Receive get_data.
+//-----------------------------------------------------------------------------
+
+bool protocol_compact_block_out::handle_receive_get_data(const code& ec,
+    get_data_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting inventory from [" << authority() << "] "
+            << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    // Ignore non-compact inventory requests in this protocol.
+    for (const auto& inventory: message->inventories)
+        if (inventory.type == inventory::type_id::compact_block)
+            blockchain_.fetch_block(inventory.hash,
+                BIND3(send_compact_block, _1, _2, inventory.hash));
+
+    return true;
+}
+
+void protocol_compact_block_out::send_compact_block(const code& ec,
+    chain::block::ptr block, const hash_digest& hash)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Compact block requested by [" << authority()
+            << "] not found.";
+
+        const not_found reply{ { inventory::type_id::compact_block, hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating compact block requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    const auto compact = to_compact(*block);
+    SEND2(compact, handle_send, _1, compact.command);
+}
+
+// Receive get_block_transactions.
+//-----------------------------------------------------------------------------
+
+bool protocol_compact_block_out::handle_receive_get_block_transactions(
+    const code& ec, get_block_transactions_ptr message)
+{
+    if (stopped())
+        return false;
+
+    if (ec)
+    {
+        log::trace(LOG_NODE)
+            << "Failure getting block transaction request from ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    blockchain_.fetch_block(message->block_hash,
+        BIND3(send_block_transactions, _1, _2, message));
+    return true;
+}
+
+void protocol_compact_block_out::send_block_transactions(const code& ec,
+    chain::block::ptr block, get_block_transactions_ptr message)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return;
+
+    if (ec == (code)error::not_found)
+    {
+        log::trace(LOG_NODE)
+            << "Block transactions requested by [" << authority()
+            << "] not found.";
+
+        const not_found reply{ { inventory::type_id::block,
+            message->block_hash } };
+        SEND2(reply, handle_send, _1, reply.command);
+        return;
+    }
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Internal failure locating block transactions requested by ["
+            << authority() << "] " << ec.message();
+        stop(ec);
+        return;
+    }
+
+    block_transactions reply;
+    reply.block_hash = message->block_hash;
+    reply.transactions.reserve(message->indexes.size());
+
+    // Requested indexes are differentially encoded, each relative to the
+    // position after the previous one.
+    const auto count = block->transactions.size();
+    uint64_t position = 0;
+    for (const auto index: message->indexes)
+    {
+        if (index >= count - position)
+        {
+            log::debug(LOG_NODE)
+                << "Invalid block transaction index from [" << authority()
+                << "]";
+            stop(error::bad_stream);
+            return;
+        }
+
+        position += index;
+        reply.transactions.push_back(block->transactions[position++]);
+    }
+
+    SEND2(reply, handle_send, _1, reply.command);
+}
+
+// Subscription.
+//-----------------------------------------------------------------------------
+
+// Only the new top is pushed, compact blocks are of no use while syncing.
+bool protocol_compact_block_out::handle_reorganized(const code& ec,
+    size_t fork_point, const block_ptr_list& incoming,
+    const block_ptr_list& outgoing)
+{
+    if (stopped() || ec == (code)error::service_stopped)
+        return false;
+
+    if (ec == (code)error::mock)
+        return true;
+
+    if (ec)
+    {
+        log::error(LOG_NODE)
+            << "Failure handling reorganization: " << ec.message();
+        stop(ec);
+        return false;
+    }
+
+    if (!high_bandwidth_ || incoming.empty() || channel_congested())
+        return true;
+
+    const auto& top = incoming.back();
+    if (top->originator() == nonce())
+        return true;
+
+    const auto compact = to_compact(*top);
+    SEND2(compact, handle_send, _1, compact.command);
+    return true;
+}
+
+void protocol_compact_block_out::handle_stop(const code&)
+{
+    log::trace(LOG_NETWORK)
+        << "Stopped compact_block_out protocol";
+    blockchain_.fired();
+}
+
+// Utility.
+//-----------------------------------------------------------------------------
+
+compact_block protocol_compact_block_out::to_compact(const chain::block& block)
+{
+    compact_block compact;
+    compact.header = block.header;
+    compact.nonce = pseudo_random();
+
+    if (block.transactions.empty())
+        return compact;
+
+    // The coinbase is always prefilled, no peer can have it in its pool.
+    prefilled_transaction coinbase;
+    coinbase.index = 0;
+    coinbase.transaction = block.transactions.front();
+    compact.transactions.push_back(coinbase);
+
+    const short_id_hasher hasher(compact.header, compact.nonce);
+    compact.short_ids.reserve(block.transactions.size() - 1);
+
+    for (auto tx = block.transactions.begin() + 1;
+        tx != block.transactions.end(); ++tx)
+        compact.short_ids.push_back(
+            short_id_hasher::to_mini_hash(hasher(tx->hash())));
+
+    return compact;
+}
+
+} // namespace node
+} // namespace libbitcoin
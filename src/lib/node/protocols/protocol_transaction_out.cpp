@@ -20,6 +20,7 @@
  */
 #include <metaverse/node/protocols/protocol_transaction_out.hpp>
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -36,6 +37,9 @@ using namespace bc::message;
 using namespace bc::network;
 using namespace std::placeholders;
 
+// The number of transaction hashes per mempool inventory message.
+static constexpr size_t memory_pool_batch = 1000;
+
 protocol_transaction_out::protocol_transaction_out(p2p& network,
     channel::ptr channel, block_chain& blockchain, transaction_pool& pool)
   : protocol_events(network, channel, NAME),
@@ -47,6 +51,7 @@ protocol_transaction_out::protocol_transaction_out(p2p& network,
 
     // TODO: move relay to a derived class protocol_transaction_out_70001.
     relay_to_peer_(peer_version().relay),
+    fee_filter_from_peer_(peer_version().value >= version::level::bip133),
     CONSTRUCT_TRACK(protocol_transaction_out)
 {
 }
@@ -54,7 +59,11 @@ protocol_transaction_out::protocol_transaction_out(p2p& network,
 protocol_transaction_out::ptr protocol_transaction_out::do_subscribe()
 {
     SUBSCRIBE2(memory_pool, handle_receive_memory_pool, _1, _2);
-    SUBSCRIBE2(fee_filter, handle_receive_fee_filter, _1, _2);
+
+    // TODO: move fee filter to a derived class protocol_transaction_out_70013.
+    if (fee_filter_from_peer_)
+        SUBSCRIBE2(fee_filter, handle_receive_fee_filter, _1, _2);
+
     SUBSCRIBE2(get_data, handle_receive_get_data, _1, _2);
     protocol_events::start(BIND1(handle_stop, _1));
     return std::dynamic_pointer_cast<protocol_transaction_out>(protocol::shared_from_this());
@@ -78,9 +87,6 @@ void protocol_transaction_out::start()
 		}
     }
 
-    // TODO: move fee filter to a derived class protocol_transaction_out_70013.
-    // Filter announcements by fee if set.
-
 }
 
 // Receive send_headers.
@@ -102,8 +108,15 @@ bool protocol_transaction_out::handle_receive_fee_filter(const code& ec,
         return false;
     }
 
-    // TODO: move fee filter to a derived class protocol_transaction_out_70013.
-    // Transaction annoucements will be filtered by fee amount.
+    // An out of range filter would suppress all announcements.
+    if (message->minimum_fee > max_money())
+    {
+        log::debug(LOG_NODE)
+            << "Invalid fee filter from [" << authority() << "]";
+        return true;
+    }
+
+    // Transaction annoucements will be filtered by fee rate (per kilobyte).
     minimum_fee_.store(message->minimum_fee);
 
     // The fee filter may be adjusted.
@@ -124,26 +137,46 @@ bool protocol_transaction_out::handle_receive_memory_pool(const code& ec,
         return false;
     }
 
-    auto self = shared_from_this();
-    pool_.fetch([this, self](const code& ec, const std::vector<transaction_ptr>& txs){
-        if (stopped() || ec) {
-            log::debug(LOG_NODE) << "pool fetch transaction failed," << ec.message();
-            return;
-        }
-
-        if (txs.empty()) {
-            return;
-        }
-        std::vector<hash_digest> hashes;
-        hashes.reserve(txs.size());
-        for(auto& t:txs) {
-            hashes.push_back(t->hash());
-        }
-        send<protocol_transaction_out>(inventory{hashes, inventory::type_id::transaction}, &protocol_transaction_out::handle_send, _1, inventory::command);
-    });
+    pool_.fetch(BIND2(handle_fetch_memory_pool, _1, _2));
     return false;
 }
 
+void protocol_transaction_out::handle_fetch_memory_pool(const code& ec,
+    const transaction_ptr_list& transactions)
+{
+    if (stopped() || ec) {
+        log::debug(LOG_NODE) << "pool fetch transaction failed," << ec.message();
+        return;
+    }
+
+    // The response is subject to the peer's fee filter.
+    const auto minimum_fee = minimum_fee_.load();
+    const auto hashes = std::make_shared<hash_list>();
+    hashes->reserve(transactions.size());
+
+    for (const auto& tx: transactions)
+        if (minimum_fee == 0 || fee_rate(*tx) >= minimum_fee)
+            hashes->push_back(tx->hash());
+
+    send_memory_pool(error::success, hashes, 0);
+}
+
+// Each batch is sent once the previous one is written, so that a large pool
+// does not occupy the send queue or one oversized message.
+void protocol_transaction_out::send_memory_pool(const code& ec,
+    hash_list_ptr hashes, size_t offset)
+{
+    if (stopped() || ec || offset >= hashes->size())
+        return;
+
+    const auto begin = hashes->begin() + offset;
+    const auto count = std::min(memory_pool_batch, hashes->size() - offset);
+    const inventory batch{ hash_list(begin, begin + count),
+        inventory::type_id::transaction };
+
+    SEND3(batch, send_memory_pool, _1, hashes, offset + count);
+}
+
 // Receive get_data sequence.
 //-----------------------------------------------------------------------------
 
@@ -240,22 +273,43 @@ bool protocol_transaction_out::handle_floated(const code& ec,
         return false;
     }
 
-    // TODO: move fee filter to a derived class protocol_transaction_out_70013.
-    // TODO: implement fee computation.
-    const uint64_t fee = 0;
-
-    // Transactions are discovered and announced individually.
-    if (message->originator() != nonce() && fee >= minimum_fee_.load())
+    // The peer can learn of the transaction from others, so announcements
+    // are dropped while it is not keeping up.
+    if (channel_congested())
     {
-        static const auto id = inventory::type_id::transaction;
-        const inventory announcement{ { id, message->hash() } };
-        log::trace(LOG_NODE) << "handle floated send transaction hash," << encode_hash(message->hash()) ;
-        SEND2(announcement, handle_send, _1, announcement.command);
+        log::trace(LOG_NODE) << "Skipping transaction announcement to ["
+            << authority() << "], send queue congested.";
+        return true;
     }
 
+    // Transactions are discovered and announced individually.
+    if (message->originator() == nonce())
+        return true;
+
+    // TODO: move fee filter to a derived class protocol_transaction_out_70013.
+    const auto minimum_fee = minimum_fee_.load();
+    if (minimum_fee > 0 && fee_rate(*message) < minimum_fee)
+        return true;
+
+    static const auto id = inventory::type_id::transaction;
+    const inventory announcement{ { id, message->hash() } };
+    log::trace(LOG_NODE) << "handle floated send transaction hash," << encode_hash(message->hash()) ;
+    SEND2(announcement, handle_send, _1, announcement.command);
     return true;
 }
 
+// The fee rate in the units of the fee filter, satoshi per kilobyte.
+uint64_t protocol_transaction_out::fee_rate(const transaction_message& tx)
+{
+    const auto size = tx.serialized_size(version::level::maximum);
+    if (size == 0)
+        return 0;
+
+    // Split to avoid overflow of fee * 1000.
+    const auto fee = tx.fee();
+    return (fee / size) * 1000 + (fee % size) * 1000 / size;
+}
+
 void protocol_transaction_out::handle_stop(const code&)
 {
     log::trace(LOG_NETWORK)
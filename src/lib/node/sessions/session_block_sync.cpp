@@ -51,7 +51,7 @@ session_block_sync::session_block_sync(p2p& network, header_queue& hashes,
     blockchain_(chain),
 	reservations_count_{0},
     settings_(settings),
-    reservations_(hashes, chain, settings),
+    reservations_(pool_, hashes, chain, settings),
     CONSTRUCT_TRACK(session_block_sync)
 {
 }
@@ -88,7 +88,8 @@ void session_block_sync::handle_started(const code& ec, result_handler handler)
         << "Getting blocks.";
     const auto connector = create_connector();
     reservations_count_ = table.size();
-    const auto complete = synchronize(handler, table.size(), NAME);
+    const auto complete = synchronize(
+        BIND2(handle_synchronized, _1, handler), table.size(), NAME);
     std::function<void(const code&)> func = complete;
     // This is the end of the start sequence.
     for (const auto row: table)
@@ -212,6 +213,26 @@ void session_block_sync::handle_complete(const code& ec, channel::ptr channel,
     new_connection(connect, row, handler);
 }
 
+// Blocks may still be staged for import when the last slot completes.
+void session_block_sync::handle_synchronized(const code& ec,
+    result_handler handler)
+{
+    const auto self = shared_from_this();
+    reservations_.flush([this, self, ec, handler]()
+    {
+        // A block rejected after every slot completed leaves a gap.
+        if (!ec && reservations_.incomplete())
+        {
+            log::error(LOG_NODE)
+                << "Blocks were rejected after all slots completed.";
+            handler(error::merkle_mismatch);
+            return;
+        }
+
+        handler(ec);
+    });
+}
+
 void session_block_sync::handle_channel_stop(const code& ec,
 		network::connector::ptr connect, reservation::ptr row, result_handler handler)
 {
@@ -24,6 +24,8 @@
 #include <metaverse/network.hpp>
 #include <metaverse/node/protocols/protocol_block_in.hpp>
 #include <metaverse/node/protocols/protocol_block_out.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_in.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_out.hpp>
 #include <metaverse/node/protocols/protocol_transaction_in.hpp>
 #include <metaverse/node/protocols/protocol_transaction_out.hpp>
 
@@ -56,6 +58,8 @@ void session_inbound::attach_handshake_protocols(channel::ptr channel,
             auto pt_block_out = attach<protocol_block_out>(channel, blockchain_);
             auto pt_tx_in = attach<protocol_transaction_in>(channel, blockchain_, pool_);
             auto pt_tx_out = attach<protocol_transaction_out>(channel, blockchain_, pool_);
+            auto pt_compact_in = attach<protocol_compact_block_in>(channel, blockchain_, pool_);
+            auto pt_compact_out = attach<protocol_compact_block_out>(channel, blockchain_);
 
             pt_ping->do_subscribe();
             pt_address->do_subscribe();
@@ -63,14 +67,18 @@ void session_inbound::attach_handshake_protocols(channel::ptr channel,
             pt_block_out->do_subscribe();
             pt_tx_in->do_subscribe();
             pt_tx_out->do_subscribe();
+            pt_compact_in->do_subscribe();
+            pt_compact_out->do_subscribe();
 
-            channel->set_protocol_start_handler([pt_ping, pt_address, pt_block_in, pt_block_out, pt_tx_in, pt_tx_out]() {
+            channel->set_protocol_start_handler([pt_ping, pt_address, pt_block_in, pt_block_out, pt_tx_in, pt_tx_out, pt_compact_in, pt_compact_out]() {
                 pt_ping->start();
                 pt_address->start();
                 pt_block_in->start();
                 pt_block_out->start();
                 pt_tx_in->start();
                 pt_tx_out->start();
+                pt_compact_in->start();
+                pt_compact_out->start();
             });
         }
 
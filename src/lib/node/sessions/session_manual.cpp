@@ -24,6 +24,8 @@
 #include <metaverse/network.hpp>
 #include <metaverse/node/protocols/protocol_block_in.hpp>
 #include <metaverse/node/protocols/protocol_block_out.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_in.hpp>
+#include <metaverse/node/protocols/protocol_compact_block_out.hpp>
 #include <metaverse/node/protocols/protocol_transaction_in.hpp>
 #include <metaverse/node/protocols/protocol_transaction_out.hpp>
 
@@ -56,13 +58,17 @@ void session_manual::attach_handshake_protocols(channel::ptr channel,
             auto pt_block_out = attach<protocol_block_out>(channel, blockchain_)->do_subscribe();
             auto pt_tx_in = attach<protocol_transaction_in>(channel, blockchain_, pool_)->do_subscribe();
             auto pt_tx_out = attach<protocol_transaction_out>(channel, blockchain_, pool_)->do_subscribe();
-            channel->set_protocol_start_handler([pt_ping, pt_address, pt_block_in, pt_block_out, pt_tx_in, pt_tx_out]() {
+            auto pt_compact_in = attach<protocol_compact_block_in>(channel, blockchain_, pool_)->do_subscribe();
+            auto pt_compact_out = attach<protocol_compact_block_out>(channel, blockchain_)->do_subscribe();
+            channel->set_protocol_start_handler([pt_ping, pt_address, pt_block_in, pt_block_out, pt_tx_in, pt_tx_out, pt_compact_in, pt_compact_out]() {
                 pt_ping->start();
                 pt_address->start();
                 pt_block_in->start();
                 pt_block_out->start();
                 pt_tx_in->start();
                 pt_tx_out->start();
+                pt_compact_in->start();
+                pt_compact_out->start();
             });
         }
         else
@@ -0,0 +1,178 @@
+/**
+ * Copyright (c) 2011-2016 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/utility/block_pipeline.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+#define NAME "block_pipeline"
+
+using namespace bc::blockchain;
+using namespace bc::chain;
+
+block_pipeline::block_pipeline(threadpool& pool, simple_chain& chain,
+    size_t first_height, size_t window)
+  : chain_(chain),
+    dispatch_(pool, NAME),
+    window_(window),
+    preparing_(0),
+    next_height_(first_height),
+    committing_(false),
+    flushing_(false)
+{
+}
+
+bool block_pipeline::import(block::ptr block, size_t height,
+    result_handler handler)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        unique_lock lock(mutex_);
+
+        // Fall back to a direct import rather than block the channel.
+        if (staged_.size() + preparing_ >= window_)
+        {
+            lock.unlock();
+            const auto imported = chain_.import(block, height);
+            handler(imported ? error::success : error::service_stopped);
+            return imported;
+        }
+
+        ++preparing_;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    dispatch_.concurrent(&block_pipeline::prepare, shared_from_this(),
+        block, height, handler);
+    return true;
+}
+
+// Compute and cache the transaction hashes off the committer, the header
+// hash is cached by the reservation.
+void block_pipeline::prepare(block::ptr block, size_t height,
+    result_handler handler)
+{
+    const auto merkle = block::generate_merkle_root(block->transactions);
+    const auto valid = merkle == block->header.merkle;
+
+    // The block is requested again, the commit does not wait for it. This
+    // precedes the count so a flush completes only after the rejection.
+    if (!valid)
+        handler(error::merkle_mismatch);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        unique_lock lock(mutex_);
+        --preparing_;
+
+        if (valid)
+            staged_.emplace(height, staged_block{ block, handler });
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    commit();
+}
+
+// Import staged blocks in height order, one committer at a time. A missing
+// height is waited for until half the window is staged.
+void block_pipeline::commit()
+{
+    while (true)
+    {
+        block::ptr block;
+        result_handler handler;
+        size_t height;
+        completion_handler flushed;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        {
+            unique_lock lock(mutex_);
+
+            if (committing_)
+                return;
+
+            if (staged_.empty())
+            {
+                if (flushing_ && preparing_ == 0 && flushed_)
+                    std::swap(flushed, flushed_);
+            }
+            else
+            {
+                const auto first = staged_.begin();
+                if (first->first == next_height_ || flushing_ ||
+                    staged_.size() >= window_ / 2)
+                {
+                    committing_ = true;
+                    height = first->first;
+                    block = first->second.block;
+                    handler = first->second.handler;
+                    staged_.erase(first);
+                }
+            }
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        if (flushed)
+        {
+            flushed();
+            return;
+        }
+
+        if (!block)
+            return;
+
+        const auto imported = chain_.import(block, height);
+        handler(imported ? error::success : error::service_stopped);
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        unique_lock lock(mutex_);
+        committing_ = false;
+        next_height_ = height + 1;
+        ///////////////////////////////////////////////////////////////////////
+    }
+}
+
+void block_pipeline::flush(completion_handler handler)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    {
+        unique_lock lock(mutex_);
+        flushing_ = true;
+        flushed_ = handler;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    commit();
+}
+
+#undef NAME
+
+} // namespace node
+} // namespace libbitcoin
@@ -55,6 +55,7 @@ reservation::reservation(reservations& reservations, size_t slot,
     stopped_(false),
     pending_(true),
     partitioned_(false),
+    rejected_(false),
     reservations_(reservations),
     slot_(slot),
     rate_window_(minimum_history * block_timeout_seconds * micro_per_second)
@@ -332,35 +333,90 @@ void reservation::import(block::ptr block)
         return;
     }
 
+    const auto self = shared_from_this();
+    const auto handler = [self, hash, height](const code& ec)
+    {
+        self->handle_import(ec, hash, height);
+    };
+
     bool success;
-    const auto importer = [this, &block, &height, &success]()
+    const auto importer = [this, &block, &height, &handler, &success]()
     {
-        success = reservations_.import(block, height);
+        success = reservations_.import(block, height, handler);
     };
 
-    // Do the block import with timer.
+    // Stage the block import with timer, the import may complete later.
     const auto cost = timer<microseconds>::duration(importer);
 
     if (success)
     {
         static const auto unit_size = 1u;
         update_rate(unit_size, cost);
-        const auto record = rate();
-        static const auto formatter =
-            "Imported block #%06i (%02i) [%s] %06.2f %05.2f%%";
+    }
+
+    populate();
+}
 
-        log::info(LOG_NODE)
-            << boost::format(formatter) % height % slot() % encoded %
-            (record.total() * micro_per_second) % (record.ratio() * 100);
+void reservation::handle_import(const code& ec, const hash_digest& hash,
+    uint32_t height)
+{
+    const auto encoded = encode_hash(hash);
+
+    if (ec == error::merkle_mismatch)
+    {
+        log::warning(LOG_NODE)
+            << "Rejected block #" << height << " (" << slot() << ") ["
+            << encoded << "] with a merkle root that does not match its "
+            << "header.";
+        reject(hash, height);
+        return;
     }
-    else
+
+    if (ec)
     {
         log::debug(LOG_NODE)
             << "Stopped before importing block (" << slot() << ") ["
             << encoded << "]";
+        return;
     }
 
-    populate();
+    const auto record = rate();
+    static const auto formatter =
+        "Imported block #%06i (%02i) [%s] %06.2f %05.2f%%";
+
+    log::info(LOG_NODE)
+        << boost::format(formatter) % height % slot() % encoded %
+        (record.total() * micro_per_second) % (record.ratio() * 100);
+}
+
+// Flag the peer for stop and hand the hash to a live row for request again.
+// The import completes asynchronously, so this row may have stopped since.
+void reservation::reject(const hash_digest& hash, uint32_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    hash_mutex_.lock();
+    rejected_ = true;
+    hash_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (!reservations_.restore(hash, height))
+        log::error(LOG_NODE)
+            << "No slot left to request block #" << height << " ["
+            << encode_hash(hash) << "] again, the sync is incomplete.";
+}
+
+bool reservation::restore(const hash_digest& hash, size_t height)
+{
+    if (stopped())
+        return false;
+
+    insert(hash, height);
+
+    // A row that stopped in between will not request it, so take it back,
+    // unless a partition already moved it on to another row.
+    uint32_t ignored;
+    return !stopped() || !find_height_and_erase(hash, ignored);
 }
 
 void reservation::populate()
@@ -406,6 +462,28 @@ bool reservation::toggle_partitioned()
     return false;
 }
 
+bool reservation::toggle_rejected()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    hash_mutex_.lock_upgrade();
+
+    if (rejected_)
+    {
+        //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+        hash_mutex_.unlock_upgrade_and_lock();
+        rejected_ = false;
+        hash_mutex_.unlock();
+        //---------------------------------------------------------------------
+        return true;
+    }
+
+    hash_mutex_.unlock_upgrade();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return false;
+}
+
 // Give the minimal row ~ half of our hashes, return false if minimal is empty.
 bool reservation::partition(reservation::ptr minimal)
 {
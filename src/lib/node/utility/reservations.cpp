@@ -40,20 +40,71 @@ using namespace bc::chain;
 // The protocol maximum size of get data block requests.
 static constexpr size_t max_block_request = 50000;
 
-reservations::reservations(header_queue& hashes, simple_chain& chain,
-    const settings& settings)
+// The maximum number of downloaded blocks held for in order import.
+static constexpr size_t pipeline_window = 1000;
+
+// The lowest height missing from the chain, where in order import starts.
+static size_t first_missing(simple_chain& chain, size_t start)
+{
+    uint64_t height;
+    if (chain.get_next_gap(height, start))
+        return static_cast<size_t>(height);
+
+    if (!chain.get_last_height(height))
+        return start;
+
+    return static_cast<size_t>(height + 1);
+}
+
+reservations::reservations(threadpool& pool, header_queue& hashes,
+    simple_chain& chain, const settings& settings)
   : hashes_(hashes),
     blockchain_(chain),
+    pipeline_(std::make_shared<block_pipeline>(pool, chain,
+        first_missing(chain, hashes.first_height()), pipeline_window)),
     max_request_(max_block_request),
-    timeout_(settings.block_timeout_seconds)
+    timeout_(settings.block_timeout_seconds),
+    incomplete_(false)
 {
     initialize(settings.download_connections);
 }
 
-bool reservations::import(block::ptr block, size_t height)
+bool reservations::import(block::ptr block, size_t height,
+    block_pipeline::result_handler handler)
 {
     // Thread safe.
-    return blockchain_.import(block, height);
+    return pipeline_->import(block, height, handler);
+}
+
+void reservations::flush(completion_handler handler)
+{
+    pipeline_->flush(handler);
+}
+
+// Rows that completed are removed from the table, stopped rows are skipped.
+bool reservations::restore(const hash_digest& hash, size_t height)
+{
+    // Copy row pointer table to prevent need for lock during iteration.
+    auto rows = table();
+    const auto comparer = [](reservation::ptr left, reservation::ptr right)
+    {
+        return left->size() < right->size();
+    };
+
+    // The row with the fewest hashes requests it soonest.
+    std::sort(rows.begin(), rows.end(), comparer);
+
+    for (const auto row: rows)
+        if (row->restore(hash, height))
+            return true;
+
+    incomplete_ = true;
+    return false;
+}
+
+bool reservations::incomplete() const
+{
+    return incomplete_;
 }
 
 // Rate methods.
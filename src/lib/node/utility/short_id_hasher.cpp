@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/node/utility/short_id_hasher.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <metaverse/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+static constexpr uint64_t short_id_mask = 0xffffffffffff;
+
+short_id_hasher::short_id_hasher(const chain::header& header, uint64_t nonce)
+{
+    auto data = header.to_data(false);
+    extend_data(data, to_little_endian(nonce));
+
+    const auto digest = sha256_hash(data);
+    k0_ = from_little_endian_unsafe<uint64_t>(digest.begin());
+    k1_ = from_little_endian_unsafe<uint64_t>(digest.begin() + sizeof(uint64_t));
+}
+
+uint64_t short_id_hasher::operator()(const hash_digest& tx_hash) const
+{
+    return siphash24(k0_, k1_, tx_hash) & short_id_mask;
+}
+
+uint64_t short_id_hasher::to_number(const mini_hash& id)
+{
+    uint64_t value = 0;
+    for (size_t byte = 0; byte < id.size(); ++byte)
+        value |= uint64_t(id[byte]) << (8 * byte);
+
+    return value;
+}
+
+mini_hash short_id_hasher::to_mini_hash(uint64_t id)
+{
+    mini_hash value;
+    for (size_t byte = 0; byte < value.size(); ++byte)
+        value[byte] = static_cast<uint8_t>(id >> (8 * byte));
+
+    return value;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -18,6 +18,10 @@
  * You should have received a copy of the GNU Affero General Public License
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
+#include <cctype>
+#include <iostream>
+#include <string>
+#include <vector>
 #include <metaverse/bitcoin/utility/path.hpp>
 #include <metaverse/bitcoin/unicode/ifstream.hpp>
 #include <boost/program_options.hpp>
@@ -61,6 +65,103 @@ void my_impl(const http_message* hm)
     }
 }
 
+// Split a batch line into arguments, quotes group words and are removed.
+std::vector<std::string> split_line(const std::string& line)
+{
+    std::vector<std::string> args;
+    std::string arg;
+    bool in_arg = false;
+    char quote = 0;
+
+    for (const auto character : line) {
+        if (quote != 0) {
+            if (character == quote)
+                quote = 0;
+            else
+                arg += character;
+        }
+        else if (character == '"' || character == '\'') {
+            quote = character;
+            in_arg = true;
+        }
+        else if (std::isspace(static_cast<unsigned char>(character))) {
+            if (in_arg)
+                args.emplace_back(std::move(arg));
+            arg.clear();
+            in_arg = false;
+        }
+        else {
+            arg += character;
+            in_arg = true;
+        }
+    }
+
+    if (in_arg)
+        args.emplace_back(std::move(arg));
+
+    return args;
+}
+
+/**
+ * Run one command per line of the input over a single kept-alive connection.
+ * Each response is written as one line of json in input order, a request
+ * that got no reply is answered with an error. Empty lines and lines
+ * starting with '#' are skipped.
+ * @return  Zero if every command succeeded.
+ */
+int batch(const std::string& url, std::istream& input)
+{
+    Json::Value response;
+    Json::Reader reader;
+
+    HttpReq req(url, 3000, reply_handler([&](const http_message* hm) {
+        const std::string reply(hm->body.p, hm->body.len);
+        if (!reader.parse(reply, response) || !response.isObject()) {
+            response = Json::objectValue;
+            response["error"]["code"] = 1000;
+            response["error"]["message"] = reply;
+        }
+    }));
+    req.set_keep_alive(true);
+
+    Json::FastWriter writer;
+    int failures = 0;
+    int id = 0;
+    std::string line;
+
+    while (std::getline(input, line)) {
+        const auto args = split_line(line);
+        if (args.empty() || args.front().front() == '#')
+            continue;
+
+        Json::Value jsonvar;
+        jsonvar["jsonrpc"] = "2.0";
+        jsonvar["id"] = ++id;
+        jsonvar["method"] = args.front();
+        jsonvar["params"] = Json::arrayValue;
+
+        for (size_t i = 1; i < args.size(); i++)
+            jsonvar["params"].append(args[i]);
+
+        response = Json::nullValue;
+        req.post(writer.write(jsonvar));
+
+        if (response.isNull()) {
+            response["jsonrpc"] = "2.0";
+            response["error"]["code"] = 1000;
+            response["error"]["message"] = "no reply from " + url;
+        }
+
+        response["id"] = id;
+        if (response.isMember("error"))
+            ++failures;
+
+        bc::cout << writer.write(response) << std::flush;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
+
 int bc::main(int argc, char* argv[])
 {
     bc::set_utf8_stdout();
@@ -96,6 +197,20 @@ int bc::main(int argc, char* argv[])
         }
     }
 
+    // Commands from a file or stdin, one per line.
+    if (argc > 1 && std::string(argv[1]) == "--batch") {
+        if (argc < 3 || std::string(argv[2]) == "-")
+            return batch(url, std::cin);
+
+        bc::ifstream file(argv[2]);
+        if (!file.good()) {
+            bc::cerr << "mvs-cli: cannot read " << argv[2] << std::endl;
+            return 1;
+        }
+
+        return batch(url, file);
+    }
+
     // HTTP request call commands
     HttpReq req(url, 3000, reply_handler(my_impl));
 
@@ -56,6 +56,15 @@ void HttpServ::reset(HttpMessage& data) noexcept
 
 void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_version)
 {
+    static auto& latency = libbitcoin::metrics::histogram("mvs_rpc_request_seconds",
+        "Json-rpc request latency by command.", "command");
+    static auto& failures = libbitcoin::metrics::counter("mvs_rpc_errors_total",
+        "Json-rpc requests answered with an error by command.", "command");
+
+    const auto start = libbitcoin::asio::steady_clock::now();
+    std::string command;
+    bool failed = true;
+
     reset(data);
     StreamBuf buf{ nc.send_mbuf };
     out_.rdbuf(&buf);
@@ -67,11 +76,12 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
     };
     try {
         data.data_to_arg(rpc_version);
+        command = data.command();
 
         Json::Value jv_output;
                 
-        auto retcode = explorer::dispatch_command(data.argc(), const_cast<const char**>(data.argv()),
-            jv_output, node_, rpc_version);
+        auto retcode = explorer::dispatch_command(command, data.options(),
+            data.arguments(), jv_output, node_, rpc_version);
 
         if (retcode == console_result::failure) { // only orignal command
             if (rpc_version == 1 && !jv_output.isObject() && !jv_output.isArray()) {
@@ -95,9 +105,14 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
 
                 out_ << jv_root.toStyledString();
             }
+            failed = false;
         }
     }
     catch (const libbitcoin::explorer::explorer_exception& e) {
+        // Keep the label set bounded by the known commands.
+        if (dynamic_cast<const explorer::invalid_command_exception*>(&e))
+            command.clear();
+
         if (rpc_version == 1) {
             out_ << e;
         }
@@ -127,6 +142,24 @@ void HttpServ::rpc_request(mg_connection& nc, HttpMessage data, uint8_t rpc_vers
         }
     }
     out_.setContentLength();
+
+    if (command.empty())
+        command = "unknown";
+
+    if (failed)
+        failures.get(command).increment();
+
+    latency.get(command).observe_duration(
+        libbitcoin::asio::steady_clock::now() - start);
+}
+
+void HttpServ::metrics_request(mg_connection& nc)
+{
+    StreamBuf buf{ nc.send_mbuf };
+    out_.rdbuf(&buf);
+    out_.reset(200, "OK", "text/plain; version=0.0.4");
+    out_ << libbitcoin::metrics::to_text();
+    out_.setContentLength();
 }
 
 void HttpServ::ws_request(mg_connection& nc, WebsocketMessage ws)
@@ -180,7 +213,10 @@ void HttpServ::run() {
 
 void HttpServ::on_http_req_handler(struct mg_connection& nc, http_message& msg)
 {
-    if ((mg_ncasecmp(msg.uri.p, "/rpc/v3", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v3/", 8) == 0)) {
+    if ((msg.uri.len == 8) && (mg_ncasecmp(msg.uri.p, "/metrics", 8) == 0)) {
+        metrics_request(nc);
+    }
+    else if ((mg_ncasecmp(msg.uri.p, "/rpc/v3", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v3/", 8) == 0)) {
         rpc_request(nc, HttpMessage(&msg), 3); // v3 rpc
     }
     else if ((mg_ncasecmp(msg.uri.p, "/rpc/v2", 7) == 0) || (mg_ncasecmp(msg.uri.p, "/rpc/v2/", 8) == 0)) {
@@ -24,18 +24,6 @@ namespace mgbubble {
 
 void HttpMessage::data_to_arg(uint8_t rpc_version) {
 
-    auto vargv_to_argv = [this]() {
-        // convert to char** argv
-        int i = 0;
-        for(auto& iter : this->vargv_){
-            if (i >= max_paramters){
-                break;
-            }
-            this->argv_[i++] = iter.c_str();
-        }
-        argc_ = i;
-    };
-    
     Json::Reader reader;
     Json::Value root;
     const char* begin = body().data();
@@ -45,7 +33,7 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
     }
 
     if (root["method"].isString()) {
-        vargv_.emplace_back(root["method"].asString());
+        command_ = root["method"].asString();
     }
 
     if (root.isMember("params") && !root["params"].isArray()) {
@@ -59,7 +47,7 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
          * ******************************************/
         for (auto& param : root["params"]) {
             if (!param.isObject())
-                vargv_.emplace_back(param.asString());
+                arguments_.emplace_back(param.asString());
         }
     } else {
         /* ***************** /rpc/v2 **********************
@@ -87,44 +75,21 @@ void HttpMessage::data_to_arg(uint8_t rpc_version) {
             jsonrpc_id_ = root["id"].asInt64();
         }
 
-        // push options
+        // options are bound by name, the first object only
         for (auto& param : root["params"]) {
             if (param.isObject()) {
-                for (auto& key : param.getMemberNames()) {
-                    if (!param[key].empty()) {
-
-                        if (!param[key].isArray()) {
-                            // --option
-                            vargv_.emplace_back("--" + key);
-                            // value
-                            vargv_.emplace_back(param[key].asString());
-                        } else  {
-                            for (auto& member : param[key]) {
-                                // --option
-                                vargv_.emplace_back("--" + key);
-                                // value
-                                vargv_.emplace_back(member.asString());
-                            }
-                        }
-
-                    } else {
-                        // --option
-                        vargv_.emplace_back("--" + key);
-                    }
-                }
+                options_ = param;
                 break;
             }
         }
 
-        // push arguments at last
+        // arguments by position
         for (auto& param : root["params"]) {
             if (!param.isObject()){
-                vargv_.emplace_back(param.asString());
+                arguments_.emplace_back(param.asString());
             }
         }
     }
-
-    vargv_to_argv();
 }
 
 void WebsocketMessage::data_to_arg(uint8_t api_version) {
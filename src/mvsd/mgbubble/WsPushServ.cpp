@@ -184,6 +184,15 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
         if (bnotify)
             notify_cons.push_back(sub.first);
     }
+    static auto& fanout = metrics::histogram("mvs_ws_push_fanout",
+        "Websocket connections notified per transaction.", "",
+        { 0, 1, 2, 5, 10, 20, 50, 100, 200, 500, 1000 }).get();
+    static auto& frames = metrics::counter("mvs_ws_push_frames_total",
+        "Websocket notification frames sent.").get();
+    static auto& bytes = metrics::counter("mvs_ws_push_bytes_total",
+        "Websocket notification bytes sent.").get();
+
+    fanout.observe(notify_cons.size());
     if (notify_cons.size() == 0)
         return;
 
@@ -211,7 +220,11 @@ void WsPushServ::notify_transaction(uint32_t height, const hash_digest& block_ha
                     continue;
                 ++active_connections;
                 if (notify_nc == nc)
+                {
                     send_frame(*nc, *rep);
+                    frames.increment();
+                    bytes.increment(rep->size());
+                }
             }
             if (active_connections != map_connections_.size())
                 refresh_connections();
@@ -159,7 +159,7 @@ options_metadata parser::load_settings()
     (
         "network.protocol",
         value<uint32_t>(&configured.network.protocol),
-        "The network protocol version, defaults to 70012."
+        "The network protocol version, defaults to 70014."
     )
     (
         "network.identifier",
@@ -293,6 +293,11 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.database.stealth_start_height),
         "The lower limit of stealth indexing, defaults to 350000."
     )
+    (
+        "database.write_threads",
+        value<uint32_t>(&configured.database.write_threads),
+        "The number of threads writing a block to the databases in parallel, zero writes serially, defaults to 4."
+    )
     (
         "database.directory",
         value<path>(&configured.database.directory),
@@ -315,6 +320,21 @@ options_metadata parser::load_settings()
         value<bool>(&configured.chain.transaction_pool_consistency),
         "Enforce consistency between the pool and the blockchain, defaults to false."
     )
+    (
+        "blockchain.transaction_pool_file",
+        value<path>(&configured.chain.transaction_pool_file),
+        "The transaction pool snapshot file path, empty to disable, defaults to 'mempool.cache'."
+    )
+    (
+        "blockchain.transaction_pool_snapshot_minutes",
+        value<uint32_t>(&configured.chain.transaction_pool_snapshot_minutes),
+        "The interval between transaction pool snapshots, zero saves only on stop, defaults to 10."
+    )
+    (
+        "blockchain.script_cache_capacity",
+        value<uint32_t>(&configured.chain.script_cache_capacity),
+        "The maximum number of verified input scripts remembered from the pool, defaults to 100000."
+    )
     (
         "blockchain.use_testnet_rules",
         value<bool>(&configured.chain.use_testnet_rules),
@@ -359,6 +379,16 @@ options_metadata parser::load_settings()
         value<std::string>(&configured.server.websocket_listen),
         "The listening port for websocket pub/sub service, defaults to 127.0.0.1:8821."
     )
+    (
+        "server.stratum_listen",
+        value<std::string>(&configured.server.stratum_listen),
+        "The listening port for stratum mining service, defaults to 127.0.0.1:8822."
+    )
+    (
+        "server.stratum_share_difficulty",
+        value<uint64_t>(&configured.server.stratum_share_difficulty),
+        "The difficulty of shares submitted to stratum mining service, defaults to 100000000."
+    )
     (
         "server.query_workers",
         value<uint16_t>(&configured.server.query_workers),
@@ -414,6 +444,11 @@ options_metadata parser::load_settings()
         value<bool>(&configured.server.websocket_service_enabled),
         "Enable the websocket pub/sub service, defaults to false."
     )
+    (
+        "server.stratum_service_enabled",
+        value<bool>(&configured.server.stratum_service_enabled),
+        "Enable the stratum mining service, defaults to false."
+    )
     (
         "server.public_query_endpoint",
         value<endpoint>(&configured.server.public_query_endpoint),
@@ -490,6 +525,7 @@ bool parser::parse(int argc, const char* argv[], std::ostream& error)
         	if (get_option(variables, BS_TESTNET_VARIABLE))
 			{
 				configured.network.hosts_file = "hosts-test.cache";
+				configured.chain.transaction_pool_file = "mempool-test.cache";
 				const_cast<path&>(variables[BS_CONFIG_VARIABLE].as<path>()) = "mvs-test.conf";
 			}
             auto data_dir = variables[BS_DATADIR_VARIABLE].as<path>();
@@ -60,6 +60,7 @@ server_node::server_node(const configuration& configuration)
     public_transaction_service_(authenticator_, *this, false),
     secure_notification_worker_(authenticator_, *this, true),
     public_notification_worker_(authenticator_, *this, false),
+    stratum_service_(*this),
     miner_(*this),
     rest_server_(new mgbubble::HttpServ(webpage_path_.string().data(), *this, configuration.server.mongoose_listen)),
     push_server_(new mgbubble::WsPushServ(*this, configuration.server.websocket_listen))
@@ -136,7 +137,8 @@ void server_node::handle_running(const code& ec, result_handler handler)
 bool server_node::stop()
 {
     // Suspend new work last so we can use work to clear subscribers.
-    return authenticator_.stop() && p2p_node::stop();
+    return stratum_service_.stop() && authenticator_.stop() &&
+        p2p_node::stop();
 }
 
 // This must be called from the thread that constructed this class (see join).
@@ -187,7 +189,7 @@ bool server_node::start_services()
     return
         start_authenticator() && start_query_services() &&
         start_heartbeat_services() && start_block_services() &&
-        start_transaction_services();
+        start_transaction_services() && start_stratum_service();
 }
 
 bool server_node::start_authenticator()
@@ -282,6 +284,16 @@ bool server_node::start_transaction_services()
     return true;
 }
 
+bool server_node::start_stratum_service()
+{
+    const auto& settings = configuration_.server;
+
+    if (!settings.stratum_service_enabled)
+        return true;
+
+    return stratum_service_.start();
+}
+
 // Called from start_query_services.
 bool server_node::start_query_workers(bool secure)
 {
@@ -363,8 +375,11 @@ uint32_t server_node::threads_required(const configuration& configuration)
         required += (settings.secure_only ? 0 : 1);
     }
 
+    // The stratum service verifies shares on a pool thread.
+    const auto stratum = settings.stratum_service_enabled ? 1 : 0;
+
     // If any services are enabled increment for the authenticator.
-    return required == 1 ? required : required + 1;
+    return (required == 1 ? required : required + 1) + stratum;
 }
 
 boost::filesystem::path server_node::webpage_path_ = webpage_path();
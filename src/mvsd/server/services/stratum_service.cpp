@@ -0,0 +1,748 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/services/stratum_service.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <metaverse/consensus/miner/MinerAux.h>
+#include <metaverse/consensus/libdevcore/BasicType.h>
+#include <metaverse/server/server_node.hpp>
+#include <metaverse/server/settings.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+using namespace std::placeholders;
+using namespace bc::chain;
+
+static const auto domain = "stratum";
+
+// Largest accepted request line, longer lines drop the connection.
+static constexpr size_t max_line_size = 4096;
+
+// Pool updates are batched into one template rebuild per interval.
+static const asio::seconds template_refresh_interval(10);
+
+struct stratum_service::session
+{
+    session(asio::service& service)
+      : socket(service),
+        strand(service),
+        buffer(max_line_size),
+        logged_in(false),
+        accepted_work(0),
+        connected(asio::steady_clock::now())
+    {
+        statistics = { "", "", 0, 0, 0, 0, 0, 0 };
+    }
+
+    asio::socket socket;
+
+    // Serializes socket reads and writes, and owns the outbound queue.
+    boost::asio::io_service::strand strand;
+    boost::asio::streambuf buffer;
+    std::deque<std::string> outbound;
+
+    // Protects all members below.
+    std::mutex mutex;
+    worker_statistics statistics;
+    bool logged_in;
+    uint64_t accepted_work;
+    asio::time_point connected;
+};
+
+namespace {
+
+Json::Value make_result(const Json::Value& id, const Json::Value& result)
+{
+    Json::Value reply;
+    reply["id"] = id;
+    reply["jsonrpc"] = "2.0";
+    reply["result"] = result;
+    return reply;
+}
+
+Json::Value make_error(const Json::Value& id, int code, const std::string& message)
+{
+    Json::Value reply;
+    reply["id"] = id;
+    reply["jsonrpc"] = "2.0";
+    reply["result"] = Json::nullValue;
+    reply["error"]["code"] = code;
+    reply["error"]["message"] = message;
+    return reply;
+}
+
+std::string strip_hex_prefix(const std::string& value)
+{
+    if (value.size() >= 2 && value[0] == '0' && (value[1] == 'x' || value[1] == 'X'))
+        return value.substr(2);
+    return value;
+}
+
+// Shares are checked at the lower of the block and the configured share
+// difficulty, so the share boundary is never below the block boundary.
+h256 share_boundary(const chain::header& header, uint64_t share_difficulty)
+{
+    chain::header share_header(header);
+    if (share_difficulty != 0 && share_header.bits > share_difficulty)
+        share_header.bits = share_difficulty;
+    return HeaderAux::boundary(share_header);
+}
+
+} // namespace
+
+stratum_service::stratum_service(server_node& node)
+  : settings_(node.server_settings()),
+    stopped_(true),
+    node_(node),
+    acceptor_(node.thread_pool().service()),
+    template_timer_(std::make_shared<deadline>(node.thread_pool(),
+        template_refresh_interval)),
+    template_refresh_pending_(false),
+    verifying_(false)
+{
+}
+
+// There is no unsubscribe so this class shouldn't be restarted.
+bool stratum_service::start()
+{
+    if (!settings_.stratum_service_enabled)
+        return true;
+
+    const auto& listen = settings_.stratum_listen;
+    const auto separator = listen.rfind(':');
+    boost::system::error_code ec;
+    asio::endpoint endpoint;
+
+    try
+    {
+        const auto host = listen.substr(0, separator);
+        const auto port = std::stoi(listen.substr(separator + 1));
+        endpoint = asio::endpoint(asio::address::from_string(host), port);
+    }
+    catch (const std::exception&)
+    {
+        log::error(LOG_SERVER)
+            << "Invalid " << domain << " listen address: " << listen;
+        return false;
+    }
+
+    acceptor_.open(endpoint.protocol(), ec);
+    if (!ec)
+        acceptor_.set_option(asio::acceptor::reuse_address(true), ec);
+    if (!ec)
+        acceptor_.bind(endpoint, ec);
+    if (!ec)
+        acceptor_.listen(asio::max_connections, ec);
+
+    if (ec)
+    {
+        log::error(LOG_SERVER)
+            << "Failed to bind " << domain << " service to " << listen
+            << " : " << ec.message();
+        return false;
+    }
+
+    stopped_ = false;
+
+    // Subscribe to blockchain reorganizations to push new jobs.
+    node_.subscribe_blockchain(
+        std::bind(&stratum_service::handle_reorganization,
+            this, _1, _2, _3, _4));
+
+    // Subscribe to pool updates to push jobs with new transactions.
+    node_.subscribe_transaction_pool(
+        std::bind(&stratum_service::handle_pool_transaction,
+            this, _1, _2, _3));
+
+    refresh_job();
+    accept();
+
+    log::info(LOG_SERVER)
+        << "Bound " << domain << " service to " << listen;
+    return true;
+}
+
+// No unsubscribe so must be kept in scope until subscriber stop complete.
+bool stratum_service::stop()
+{
+    if (stopped_.exchange(true))
+        return true;
+
+    template_timer_->stop();
+
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+
+    std::set<session_ptr> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions.swap(sessions_);
+    }
+
+    for (const auto& session : sessions)
+        session->socket.close(ec);
+
+    return true;
+}
+
+std::vector<stratum_service::worker_statistics> stratum_service::workers() const
+{
+    std::vector<worker_statistics> result;
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+
+    for (const auto& session : sessions_)
+    {
+        std::lock_guard<std::mutex> session_lock(session->mutex);
+        if (!session->logged_in)
+            continue;
+
+        auto statistics = session->statistics;
+        const auto elapsed = std::chrono::duration_cast<asio::seconds>(
+            asio::steady_clock::now() - session->connected).count();
+        statistics.estimated_hashrate = session->accepted_work /
+            std::max<int64_t>(elapsed, 1);
+        result.push_back(statistics);
+    }
+
+    return result;
+}
+
+// Connections.
+//-----------------------------------------------------------------------------
+
+void stratum_service::accept()
+{
+    if (stopped_)
+        return;
+
+    auto session = std::make_shared<stratum_service::session>(
+        node_.thread_pool().service());
+
+    acceptor_.async_accept(session->socket,
+        std::bind(&stratum_service::handle_accept,
+            this, _1, session));
+}
+
+void stratum_service::handle_accept(const boost::system::error_code& ec,
+    session_ptr session)
+{
+    if (stopped_)
+        return;
+
+    if (!ec)
+    {
+        boost::system::error_code endpoint_ec;
+        const auto remote = session->socket.remote_endpoint(endpoint_ec);
+        session->statistics.authority = config::authority(remote).to_string();
+
+        {
+            std::lock_guard<std::mutex> lock(sessions_mutex_);
+            sessions_.insert(session);
+        }
+
+        read(session);
+    }
+    else
+    {
+        log::debug(LOG_SERVER)
+            << "Failure accepting " << domain << " connection: " << ec.message();
+    }
+
+    accept();
+}
+
+void stratum_service::read(session_ptr session)
+{
+    boost::asio::async_read_until(session->socket, session->buffer, '\n',
+        session->strand.wrap(std::bind(&stratum_service::handle_read,
+            this, _1, _2, session)));
+}
+
+void stratum_service::handle_read(const boost::system::error_code& ec,
+    size_t size, session_ptr session)
+{
+    if (stopped_)
+        return;
+
+    if (ec)
+    {
+        close(session);
+        return;
+    }
+
+    std::string line(size, '\0');
+    session->buffer.sgetn(&line[0], size);
+
+    if (!line.empty() && line.back() == '\n')
+        line.pop_back();
+    if (!line.empty() && line.back() == '\r')
+        line.pop_back();
+
+    if (!line.empty())
+        handle_request(session, line);
+
+    read(session);
+}
+
+void stratum_service::send(session_ptr session, const Json::Value& message)
+{
+    Json::FastWriter writer;
+    const auto data = std::make_shared<std::string>(writer.write(message));
+
+    session->strand.post([this, session, data]()
+    {
+        session->outbound.push_back(std::move(*data));
+
+        // A write is already in flight, it continues with this one.
+        if (session->outbound.size() == 1)
+            write(session);
+    });
+}
+
+// Called on the session strand with the outbound queue not empty.
+void stratum_service::write(session_ptr session)
+{
+    boost::asio::async_write(session->socket,
+        boost::asio::buffer(session->outbound.front()),
+        session->strand.wrap(std::bind(&stratum_service::handle_write,
+            this, _1, session)));
+}
+
+void stratum_service::handle_write(const boost::system::error_code& ec,
+    session_ptr session)
+{
+    session->outbound.pop_front();
+
+    if (ec)
+    {
+        session->outbound.clear();
+        close(session);
+        return;
+    }
+
+    if (!session->outbound.empty())
+        write(session);
+}
+
+void stratum_service::close(session_ptr session)
+{
+    boost::system::error_code ec;
+    session->socket.close(ec);
+
+    std::lock_guard<std::mutex> lock(sessions_mutex_);
+    if (sessions_.erase(session) == 0)
+        return;
+
+    std::lock_guard<std::mutex> session_lock(session->mutex);
+    if (!session->logged_in)
+        return;
+
+    const auto& statistics = session->statistics;
+    log::debug(LOG_SERVER)
+        << "Stratum worker [" << statistics.name << "] from "
+        << statistics.authority << " disconnected, accepted ("
+        << statistics.accepted_shares << ") rejected ("
+        << statistics.rejected_shares << ") stale ("
+        << statistics.stale_shares << ") blocks ("
+        << statistics.blocks_found << ")";
+}
+
+// Requests.
+//-----------------------------------------------------------------------------
+
+void stratum_service::handle_request(session_ptr session,
+    const std::string& line)
+{
+    Json::Reader reader;
+    Json::Value request;
+
+    if (!reader.parse(line, request) || !request.isObject())
+    {
+        send(session, make_error(Json::nullValue, -32700, "Parse error"));
+        return;
+    }
+
+    const auto method = request["method"].asString();
+
+    if (method == "eth_submitLogin")
+    {
+        handle_login(session, request);
+        return;
+    }
+
+    bool logged_in = false;
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        logged_in = session->logged_in;
+    }
+
+    if (!logged_in)
+        send(session, make_error(request["id"], -32000, "Not logged in"));
+    else if (method == "eth_getWork")
+        handle_get_work(session, request);
+    else if (method == "eth_submitWork")
+        handle_submit_work(session, request);
+    else if (method == "eth_submitHashrate")
+        handle_submit_hashrate(session, request);
+    else
+        send(session, make_error(request["id"], -32601, "Method not found"));
+}
+
+void stratum_service::handle_login(session_ptr session,
+    const Json::Value& request)
+{
+    const auto& params = request["params"];
+    std::string name;
+
+    if (request["worker"].isString())
+        name = request["worker"].asString();
+    else if (params.isArray() && !params.empty() && params[0u].isString())
+        name = params[0u].asString();
+
+    if (name.empty())
+    {
+        send(session, make_error(request["id"], -32602, "Invalid worker"));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->logged_in = true;
+        session->statistics.name = name;
+        session->connected = asio::steady_clock::now();
+    }
+
+    log::debug(LOG_SERVER)
+        << "Stratum worker [" << name << "] logged in from "
+        << session->statistics.authority;
+
+    send(session, make_result(request["id"], true));
+}
+
+void stratum_service::handle_get_work(session_ptr session,
+    const Json::Value& request)
+{
+    const auto result = job_result();
+
+    if (result.isNull())
+        send(session, make_error(request["id"], -32000, "No work available"));
+    else
+        send(session, make_result(request["id"], result));
+}
+
+// Shares are verified in batches, the reply is sent after verification.
+void stratum_service::handle_submit_work(session_ptr session,
+    const Json::Value& request)
+{
+    const auto& params = request["params"];
+
+    if (!params.isArray() || params.size() < 3 || !params[0u].isString() ||
+        !params[1u].isString() || !params[2u].isString())
+    {
+        send(session, make_error(request["id"], -32602, "Invalid params"));
+        return;
+    }
+
+    share item;
+    item.owner = session;
+    item.id = request["id"];
+    item.nonce = params[0u].asString();
+    item.header_hash = params[1u].asString();
+    item.mix_hash = params[2u].asString();
+
+    {
+        std::lock_guard<std::mutex> lock(job_mutex_);
+        if (job_.header_hash.empty() || item.header_hash != job_.header_hash)
+        {
+            {
+                std::lock_guard<std::mutex> session_lock(session->mutex);
+                ++session->statistics.stale_shares;
+            }
+
+            send(session, make_result(item.id, false));
+            return;
+        }
+
+        item.header = job_.header;
+    }
+
+    try
+    {
+        item.header.nonce = (u64)std::stoull(strip_hex_prefix(item.nonce), nullptr, 16);
+        item.header.mixhash = (FixedHash<32>::Arith)h256(item.mix_hash);
+    }
+    catch (const std::exception&)
+    {
+        send(session, make_error(item.id, -32602, "Invalid params"));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(shares_mutex_);
+    shares_.push_back(std::move(item));
+
+    if (!verifying_)
+    {
+        verifying_ = true;
+        node_.thread_pool().service().post(
+            std::bind(&stratum_service::verify_shares, this));
+    }
+}
+
+void stratum_service::handle_submit_hashrate(session_ptr session,
+    const Json::Value& request)
+{
+    const auto& params = request["params"];
+    uint64_t rate = 0;
+
+    if (params.isArray() && !params.empty() && params[0u].isString())
+    {
+        try
+        {
+            rate = std::stoull(strip_hex_prefix(params[0u].asString()), nullptr, 16);
+        }
+        catch (const std::exception&)
+        {
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(session->mutex);
+        session->statistics.reported_hashrate = rate;
+    }
+
+    send(session, make_result(request["id"], true));
+}
+
+// Shares.
+//-----------------------------------------------------------------------------
+
+void stratum_service::verify_shares()
+{
+    while (!stopped_)
+    {
+        std::vector<share> shares;
+        {
+            std::lock_guard<std::mutex> lock(shares_mutex_);
+            if (shares_.empty())
+            {
+                verifying_ = false;
+                return;
+            }
+
+            shares.swap(shares_);
+        }
+
+        // Batch by job, since one batch shares one seed hash.
+        std::map<std::string, std::vector<size_t>> jobs;
+        for (size_t index = 0; index < shares.size(); ++index)
+            jobs[shares[index].header_hash].push_back(index);
+
+        for (const auto& item : jobs)
+        {
+            std::vector<chain::header> headers;
+            for (const auto index : item.second)
+                headers.push_back(shares[index].header);
+
+            std::vector<h256> values;
+            MinerAux::verify(headers, values);
+
+            const auto block_boundary = HeaderAux::boundary(headers.front());
+            const auto boundary = share_boundary(headers.front(),
+                settings_.stratum_share_difficulty);
+            const auto share_work = static_cast<uint64_t>(
+                std::min<u256>(headers.front().bits, settings_.stratum_share_difficulty));
+            auto job_changed = false;
+
+            for (size_t position = 0; position < item.second.size(); ++position)
+            {
+                auto& share = shares[item.second[position]];
+                const auto& value = values[position];
+                auto accepted = value <= boundary;
+                auto found = false;
+                auto stale = false;
+
+                if (accepted && value <= block_boundary)
+                {
+                    found = node_.miner().put_result(strip_hex_prefix(share.nonce),
+                        share.mix_hash, share.header_hash, 0);
+                    stale = !found;
+                    job_changed = true;
+                }
+
+                std::string name;
+                {
+                    auto& owner = *share.owner;
+                    std::lock_guard<std::mutex> lock(owner.mutex);
+                    name = owner.statistics.name;
+                    if (stale)
+                        ++owner.statistics.stale_shares;
+                    else if (accepted)
+                        ++owner.statistics.accepted_shares;
+                    else
+                        ++owner.statistics.rejected_shares;
+
+                    if (accepted && !stale)
+                        owner.accepted_work += share_work;
+
+                    if (found)
+                        ++owner.statistics.blocks_found;
+                }
+
+                if (found)
+                    log::info(LOG_SERVER)
+                        << "Stratum worker [" << name
+                        << "] found block at height " << share.header.number;
+
+                send(share.owner, make_result(share.id, accepted && !stale));
+            }
+
+            if (job_changed && refresh_job())
+                push_job();
+        }
+    }
+}
+
+// Jobs.
+//-----------------------------------------------------------------------------
+
+bool stratum_service::handle_reorganization(const code& ec,
+    uint64_t fork_point, const block_list& new_blocks, const block_list&)
+{
+    if (stopped_ || ec == (code)error::service_stopped)
+        return false;
+
+    if (ec)
+    {
+        log::debug(LOG_SERVER)
+            << "Failure handling new block: " << ec.message();
+        return true;
+    }
+
+    // The template is rebuilt off the notification thread.
+    node_.thread_pool().service().post([this]()
+    {
+        if (!stopped_ && refresh_job())
+            push_job();
+    });
+
+    return true;
+}
+
+bool stratum_service::handle_pool_transaction(const code& ec,
+    const index_list&, transaction_ptr)
+{
+    if (stopped_ || ec == (code)error::service_stopped)
+        return false;
+
+    if (ec)
+    {
+        log::debug(LOG_SERVER)
+            << "Failure handling new transaction: " << ec.message();
+        return true;
+    }
+
+    // The first transaction after a rebuild arms the timer, the rest wait
+    // for the same rebuild.
+    if (!template_refresh_pending_.exchange(true))
+        template_timer_->start(
+            std::bind(&stratum_service::handle_template_timer, this, _1));
+
+    return true;
+}
+
+void stratum_service::handle_template_timer(const code& ec)
+{
+    template_refresh_pending_ = false;
+    if (stopped_ || ec)
+        return;
+
+    if (refresh_job(true))
+        push_job();
+}
+
+bool stratum_service::refresh_job(bool rebuild)
+{
+    const auto block = node_.miner().get_block(rebuild);
+    if (!block)
+        return false;
+
+    job fresh;
+    fresh.header = block->header;
+    fresh.header_hash = "0x" + HeaderAux::hashHead(fresh.header).hex();
+    fresh.seed_hash = "0x" + HeaderAux::seedHash(fresh.header).hex();
+    fresh.share_boundary = "0x" + share_boundary(fresh.header,
+        settings_.stratum_share_difficulty).hex();
+
+    std::lock_guard<std::mutex> lock(job_mutex_);
+    if (fresh.header_hash == job_.header_hash)
+        return false;
+
+    job_ = std::move(fresh);
+    return true;
+}
+
+Json::Value stratum_service::job_result() const
+{
+    std::lock_guard<std::mutex> lock(job_mutex_);
+    if (job_.header_hash.empty())
+        return Json::nullValue;
+
+    Json::Value result;
+    result.append(job_.header_hash);
+    result.append(job_.seed_hash);
+    result.append(job_.share_boundary);
+    return result;
+}
+
+void stratum_service::push_job()
+{
+    const auto result = job_result();
+    if (result.isNull())
+        return;
+
+    // Pushed jobs use id zero, as in the eth-proxy stratum dialect.
+    const auto message = make_result(0, result);
+
+    std::set<session_ptr> sessions;
+    {
+        std::lock_guard<std::mutex> lock(sessions_mutex_);
+        sessions = sessions_;
+    }
+
+    for (const auto& session : sessions)
+    {
+        bool logged_in = false;
+        {
+            std::lock_guard<std::mutex> lock(session->mutex);
+            logged_in = session->logged_in;
+        }
+
+        if (logged_in)
+            send(session, message);
+    }
+}
+
+} // namespace server
+} // namespace libbitcoin
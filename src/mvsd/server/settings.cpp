@@ -33,6 +33,8 @@ settings::settings()
     subscription_limit(100000000),
     mongoose_listen("127.0.0.1:8820"),
     websocket_listen("127.0.0.1:8821"),
+    stratum_listen("127.0.0.1:8822"),
+    stratum_share_difficulty(100000000),
     administrator_required(false),
     log_level("DEBUG"),
     secure_only(false),
@@ -41,6 +43,7 @@ settings::settings()
     block_service_enabled(false),
     transaction_service_enabled(false),
     websocket_service_enabled(true),
+    stratum_service_enabled(false),
     public_query_endpoint("tcp://*:9091"),
     public_heartbeat_endpoint("tcp://*:9092"),
     public_block_endpoint("tcp://*:9093"),
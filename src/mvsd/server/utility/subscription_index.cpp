@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2011-2015 libbitcoin developers (see AUTHORS)
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse-server.
+ *
+ * metaverse-server is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <metaverse/server/utility/subscription_index.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/server/messages/route.hpp>
+
+namespace libbitcoin {
+namespace server {
+
+subscription_index::subscription_index()
+{
+}
+
+bool subscription_index::insert(const route& reply_to, uint32_t id,
+    const binary& prefix_filter, sequence_ptr sequence)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    auto current = &root_;
+    for (binary::size_type bit = 0; bit < prefix_filter.size(); ++bit)
+    {
+        auto& child = current->children[prefix_filter[bit] ? 1 : 0];
+        if (!child)
+            child.reset(new node);
+
+        current = child.get();
+    }
+
+    auto& subscriptions = current->subscriptions;
+    const auto it = std::find_if(subscriptions.begin(), subscriptions.end(),
+        [&](const subscription& entry)
+        {
+            return entry.reply_to == reply_to;
+        });
+
+    if (it != subscriptions.end())
+        return false;
+
+    subscriptions.push_back({ reply_to, id, prefix_filter, sequence });
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool subscription_index::remove(const route& reply_to,
+    const binary& prefix_filter)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    // Keep the path so that emptied nodes can be released bottom up.
+    std::vector<node*> path{ &root_ };
+    for (binary::size_type bit = 0; bit < prefix_filter.size(); ++bit)
+    {
+        const auto& child = path.back()->children[prefix_filter[bit] ? 1 : 0];
+        if (!child)
+            return false;
+
+        path.push_back(child.get());
+    }
+
+    auto& subscriptions = path.back()->subscriptions;
+    const auto it = std::find_if(subscriptions.begin(), subscriptions.end(),
+        [&](const subscription& entry)
+        {
+            return entry.reply_to == reply_to;
+        });
+
+    if (it == subscriptions.end())
+        return false;
+
+    subscriptions.erase(it);
+
+    for (auto bit = prefix_filter.size(); bit > 0; --bit)
+    {
+        const auto child = path[bit];
+        if (!child->subscriptions.empty() || child->children[0] ||
+            child->children[1])
+            break;
+
+        path[bit - 1]->children[prefix_filter[bit - 1] ? 1 : 0].reset();
+    }
+
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+subscription_index::list subscription_index::find(const binary& field) const
+{
+    list out;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    // Each node on the path of the field holds the filters of its depth.
+    auto current = &root_;
+    for (binary::size_type bit = 0; current != nullptr; ++bit)
+    {
+        out.insert(out.end(), current->subscriptions.begin(),
+            current->subscriptions.end());
+
+        if (bit == field.size())
+            break;
+
+        current = current->children[field[bit] ? 1 : 0].get();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+} // namespace server
+} // namespace libbitcoin
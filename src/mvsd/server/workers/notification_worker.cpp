@@ -59,14 +59,15 @@ notification_worker::notification_worker(zmq::authenticator& authenticator,
     settings_(node.server_settings()),
     node_(node),
     authenticator_(authenticator),
-    payment_subscriber_(std::make_shared<payment_subscriber>(
+    payment_subscriber_(std::make_shared<subscription_notifier>(
         node.thread_pool(), settings_.subscription_limit, NAME "_payment")),
-    stealth_subscriber_(std::make_shared<stealth_subscriber>(
+    stealth_subscriber_(std::make_shared<subscription_notifier>(
         node.thread_pool(), settings_.subscription_limit, NAME "_stealth")),
-    address_subscriber_(std::make_shared<address_subscriber>(
+    address_subscriber_(std::make_shared<subscription_notifier>(
         node.thread_pool(), settings_.subscription_limit, NAME "_address")),
     penetration_subscriber_(std::make_shared<penetration_subscriber>(
-        node.thread_pool(), settings_.subscription_limit, NAME "_penetration"))
+        node.thread_pool(), settings_.subscription_limit, NAME "_penetration")),
+    dispatch_(node.thread_pool(), NAME "_dispatch")
 {
 }
 
@@ -109,14 +110,14 @@ bool notification_worker::stop()
 
     // v2/v3 (deprecated)
     payment_subscriber_->stop();
-    payment_subscriber_->invoke(code, {}, 0, {}, {});
+    payment_subscriber_->invoke(code);
 
     stealth_subscriber_->stop();
-    stealth_subscriber_->invoke(code, 0, 0, {}, {});
+    stealth_subscriber_->invoke(code);
 
     // v3
     address_subscriber_->stop();
-    address_subscriber_->invoke(code, {}, 0, {}, {});
+    address_subscriber_->invoke(code);
 
     penetration_subscriber_->stop();
     penetration_subscriber_->invoke(code, 0, {}, {});
@@ -205,11 +206,11 @@ void notification_worker::purge()
     static const auto code = error::channel_timeout;
 
     // v2/v3 (deprecated)
-    payment_subscriber_->purge(code, {}, 0, {}, {});
-    stealth_subscriber_->purge(code, 0, 0, {}, {});
+    payment_subscriber_->purge(code);
+    stealth_subscriber_->purge(code);
 
     // v3
-    address_subscriber_->purge(code, {}, 0, {}, {});
+    address_subscriber_->purge(code);
     penetration_subscriber_->purge(code, 0, {}, {});
 }
 
@@ -247,122 +248,88 @@ void notification_worker::send(const route& reply_to,
             << notification.route().display() << " " << ec.message();
 }
 
-void notification_worker::send_payment(const route& reply_to, uint32_t id,
+void notification_worker::send_payment(const subscription_list& subscribers,
     const wallet::payment_address& address, uint32_t height,
-    const hash_digest& block_hash, const chain::transaction& tx)
+    const hash_digest& block_hash, const data_chunk& tx_data)
 {
-    // [ address.version:1 ]
-    // [ address.hash:20 ]
-    // [ height:4 ]
-    // [ block_hash:32 ]
-    // [ tx:... ]
-    const auto payload = build_chunk(
+    for (const auto& subscriber: subscribers)
     {
-        to_array(address.version()),
-        address.hash(),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
-    });
-    
-    send(reply_to, address_update, id, payload);
+        // [ address.version:1 ]
+        // [ address.hash:20 ]
+        // [ height:4 ]
+        // [ block_hash:32 ]
+        // [ tx:... ]
+        const auto payload = build_chunk(
+        {
+            to_array(address.version()),
+            address.hash(),
+            to_little_endian(height),
+            block_hash,
+            tx_data
+        });
+
+        send(subscriber.reply_to, address_update, subscriber.id, payload);
+    }
 }
 
-void notification_worker::send_stealth(const route& reply_to, uint32_t id,
+void notification_worker::send_stealth(const subscription_list& subscribers,
     uint32_t prefix, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx)
+    const data_chunk& tx_data)
 {
-    // [ prefix:4 ]
-    // [ height:4 ]
-    // [ block_hash:32 ]
-    // [ tx:... ]
-    const auto payload = build_chunk(
+    for (const auto& subscriber: subscribers)
     {
-        to_little_endian(prefix),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
-    });
+        // [ prefix:4 ]
+        // [ height:4 ]
+        // [ block_hash:32 ]
+        // [ tx:... ]
+        const auto payload = build_chunk(
+        {
+            to_little_endian(prefix),
+            to_little_endian(height),
+            block_hash,
+            tx_data
+        });
 
-    send(reply_to, address_stealth, id, payload);
+        send(subscriber.reply_to, address_stealth, subscriber.id, payload);
+    }
 }
 
-void notification_worker::send_address(const route& reply_to, uint32_t id,
-    uint8_t sequence, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx)
+void notification_worker::send_address(const subscription_list& subscribers,
+    uint32_t height, const hash_digest& block_hash, const data_chunk& tx_data)
 {
-    // [ code:4 ]
-    // [ sequence:1 ]
-    // [ height:4 ]
-    // [ block_hash:32 ]
-    // [ tx:... ]
-    const auto payload = build_chunk(
+    for (const auto& subscriber: subscribers)
     {
-        message::to_bytes(error::success),
-        to_array(sequence),
-        to_little_endian(height),
-        block_hash,
-        tx.to_data()
-    });
-
-    send(reply_to, address_update2, id, payload);
+        // [ code:4 ]
+        // [ sequence:1 ]
+        // [ height:4 ]
+        // [ block_hash:32 ]
+        // [ tx:... ]
+        const auto payload = build_chunk(
+        {
+            message::to_bytes(error::success),
+            to_array(*subscriber.sequence),
+            to_little_endian(height),
+            block_hash,
+            tx_data
+        });
+
+        send(subscriber.reply_to, address_update2, subscriber.id, payload);
+        ++(*subscriber.sequence);
+    }
 }
 
 // Handlers.
 // ----------------------------------------------------------------------------
 
-bool notification_worker::handle_payment(const code& ec,
-    const payment_address& address, uint32_t height,
-    const hash_digest& block_hash, const chain::transaction& tx,
+// Events are routed by the indexes, so this only sees expiration, stop,
+// unsubscribe or a rejected subscription.
+bool notification_worker::handle_subscription(const code& ec,
+    subscription_index& index, const std::string& command,
     const route& reply_to, uint32_t id, const binary& prefix_filter)
 {
-    if (ec)
-    {
-        send(reply_to, address_update, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(address.hash()))
-        send_payment(reply_to, id, address, height, block_hash, tx);
-
-    return true;
-}
-
-bool notification_worker::handle_stealth(const code& ec,
-    uint32_t prefix, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx, const route& reply_to, uint32_t id,
-    const binary& prefix_filter)
-{
-    if (ec)
-    {
-        send(reply_to, address_stealth, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(prefix))
-        send_stealth(reply_to, id, prefix, height, block_hash, tx);
-
-    return true;
-}
-
-bool notification_worker::handle_address(const code& ec,
-    const binary& field, uint32_t height, const hash_digest& block_hash,
-    const chain::transaction& tx, const route& reply_to, uint32_t id,
-    const binary& prefix_filter, sequence_ptr sequence)
-{
-    if (ec)
-    {
-        send(reply_to, address_update2, id, message::to_bytes(ec));
-        return false;
-    }
-
-    if (prefix_filter.is_prefix_of(field))
-    {
-        send_address(reply_to, id, *sequence, height, block_hash, tx);
-        ++(*sequence);
-    }
-
-    return true;
+    index.remove(reply_to, prefix_filter);
+    send(reply_to, command, id, message::to_bytes(ec));
+    return false;
 }
 
 // Subscribers.
@@ -382,26 +349,30 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
         // v2/v3 (deprecated)
         case subscribe_type::payment:
         {
+            payment_index_.insert(reply_to, id, prefix_filter);
+
             // This class must be kept in scope until work is terminated.
             const auto handler =
-                std::bind(&notification_worker::handle_payment,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
+                std::bind(&notification_worker::handle_subscription,
+                    this, _1, std::ref(payment_index_), address_update,
+                    reply_to, id, prefix_filter);
 
-            payment_subscriber_->subscribe(handler, key, duration, error_code,
-                {}, 0, {}, {});
+            payment_subscriber_->subscribe(handler, key, duration, error_code);
             break;
         }
 
         // v2/v3 (deprecated)
         case subscribe_type::stealth:
         {
+            stealth_index_.insert(reply_to, id, prefix_filter);
+
             // This class must be kept in scope until work is terminated.
             const auto handler =
-                std::bind(&notification_worker::handle_stealth,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter);
+                std::bind(&notification_worker::handle_subscription,
+                    this, _1, std::ref(stealth_index_), address_stealth,
+                    reply_to, id, prefix_filter);
 
-            stealth_subscriber_->subscribe(handler, key, duration, error_code,
-                0, 0, {}, {});
+            stealth_subscriber_->subscribe(handler, key, duration, error_code);
             break;
         }
 
@@ -409,17 +380,18 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
         case subscribe_type::unspecified:
         {
             // The sequence enables the client to detect dropped messages.
+            // A renewal keeps the sequence of the existing subscription.
             const auto sequence = std::make_shared<uint8_t>(0);
+            address_index_.insert(reply_to, id, prefix_filter, sequence);
 
             // This class must be kept in scope until work is terminated.
             const auto handler =
-                std::bind(&notification_worker::handle_address,
-                    this, _1, _2, _3, _4, _5, reply_to, id, prefix_filter,
-                    sequence);
+                std::bind(&notification_worker::handle_subscription,
+                    this, _1, std::ref(address_index_), address_update2,
+                    reply_to, id, prefix_filter);
 
             // v3
-            address_subscriber_->subscribe(handler, key, duration, error_code,
-                {}, 0, {}, {});
+            address_subscriber_->subscribe(handler, key, duration, error_code);
             break;
         }
 
@@ -428,12 +400,12 @@ void notification_worker::subscribe_address(const route& reply_to, uint32_t id,
         case subscribe_type::unsubscribe:
         {
             // Just as with an expiration (purge) this will cause the stored
-            // handler (notification_worker::handle_address) to be invoked but
-            // with the specified error code (error::channel_stopped) as
-            // opposed to error::channel_timeout.
+            // handler (notification_worker::handle_subscription) to be
+            // invoked but with the specified error code
+            // (error::channel_stopped) as opposed to error::channel_timeout.
 
             // v3
-            address_subscriber_->unsubscribe(key, error_code, {}, 0, {}, {});
+            address_subscriber_->unsubscribe(key, error_code);
             break;
         }
     }
@@ -602,6 +574,9 @@ void notification_worker::notify_transaction(uint32_t height,
     if (stopped() || tx.outputs.empty())
         return;
 
+    // Serialized once for all of the notifications of the transaction.
+    data_chunk tx_data;
+
     // see data_base::push_inputs
     // Loop inputs and extract payment addresses.
     for (const auto& input: tx.inputs)
@@ -611,8 +586,8 @@ void notification_worker::notify_transaction(uint32_t height,
         if (address)
         {
             const binary field(address_bits, address.hash());
-            notify_address(field, height, block_hash, tx);
-            notify_payment(address, height, block_hash, tx);
+            notify_address(field, height, block_hash, tx, tx_data);
+            notify_payment(address, field, height, block_hash, tx, tx_data);
         }
     }
 
@@ -625,8 +600,8 @@ void notification_worker::notify_transaction(uint32_t height,
         if (address)
         {
             const binary field(address_bits, address.hash());
-            notify_address(field, height, block_hash, tx);
-            notify_payment(address, height, block_hash, tx);
+            notify_address(field, height, block_hash, tx, tx_data);
+            notify_payment(address, field, height, block_hash, tx, tx_data);
         }
     }
 
@@ -643,34 +618,57 @@ void notification_worker::notify_transaction(uint32_t height,
             payment_address::extract(payment_script))
         {
             const binary field(prefix_bits, to_little_endian(prefix));
-            notify_address(field, height, block_hash, tx);
-            notify_stealth(prefix, height, block_hash, tx);
+            notify_address(field, height, block_hash, tx, tx_data);
+            notify_stealth(prefix, field, height, block_hash, tx, tx_data);
         }
     }
 }
 
 // v2/v3 (deprecated)
 void notification_worker::notify_payment(const payment_address& address,
-    uint32_t height, const hash_digest& block_hash, const transaction& tx)
+    const binary& field, uint32_t height, const hash_digest& block_hash,
+    const transaction& tx, data_chunk& tx_data)
 {
-    static const auto code = error::success;
-    payment_subscriber_->relay(code, address, height, block_hash, tx);
+    auto subscribers = payment_index_.find(field);
+    if (subscribers.empty())
+        return;
+
+    if (tx_data.empty())
+        tx_data = tx.to_data();
+
+    dispatch_.ordered(&notification_worker::send_payment, this,
+        std::move(subscribers), address, height, block_hash, tx_data);
 }
 
 // v2/v3 (deprecated)
-void notification_worker::notify_stealth(uint32_t prefix, uint32_t height,
-    const hash_digest& block_hash, const transaction& tx)
+void notification_worker::notify_stealth(uint32_t prefix, const binary& field,
+    uint32_t height, const hash_digest& block_hash, const transaction& tx,
+    data_chunk& tx_data)
 {
-    static const auto code = error::success;
-    stealth_subscriber_->relay(code, prefix, height, block_hash, tx);
+    auto subscribers = stealth_index_.find(field);
+    if (subscribers.empty())
+        return;
+
+    if (tx_data.empty())
+        tx_data = tx.to_data();
+
+    dispatch_.ordered(&notification_worker::send_stealth, this,
+        std::move(subscribers), prefix, height, block_hash, tx_data);
 }
 
 // v3
 void notification_worker::notify_address(const binary& field, uint32_t height,
-    const hash_digest& block_hash, const transaction& tx)
+    const hash_digest& block_hash, const transaction& tx, data_chunk& tx_data)
 {
-    static const auto code = error::success;
-    address_subscriber_->relay(code, field, height, block_hash, tx);
+    auto subscribers = address_index_.find(field);
+    if (subscribers.empty())
+        return;
+
+    if (tx_data.empty())
+        tx_data = tx.to_data();
+
+    dispatch_.ordered(&notification_worker::send_address, this,
+        std::move(subscribers), height, block_hash, tx_data);
 }
 
 // v3.x
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef MVS_TEST_BENCHMARK_HPP
+#define MVS_TEST_BENCHMARK_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace libbitcoin {
+namespace benchmark {
+
+typedef std::chrono::steady_clock steady_clock;
+typedef std::chrono::nanoseconds nanoseconds;
+
+/// Number of heap allocations made by this process so far, counted by the
+/// replaced global operator new in allocations.cpp.
+uint64_t allocations();
+
+/// Accumulated time and allocations of one measured phase.
+struct phase
+{
+    phase(const std::string& name) : name(name), count(0), elapsed(0), allocated(0) {}
+
+    /// Run and account the handler, returning its result.
+    template <typename Handler>
+    auto measure(Handler handler) -> decltype(handler())
+    {
+        const auto allocated_start = allocations();
+        const auto start = steady_clock::now();
+        struct accumulate
+        {
+            ~accumulate()
+            {
+                self.elapsed += std::chrono::duration_cast<nanoseconds>(steady_clock::now() - start);
+                self.allocated += allocations() - allocated_start;
+                ++self.count;
+            }
+
+            phase& self;
+            const steady_clock::time_point start;
+            const uint64_t allocated_start;
+        } guard{ *this, start, allocated_start };
+
+        return handler();
+    }
+
+    double seconds() const
+    {
+        return std::chrono::duration<double>(elapsed).count();
+    }
+
+    std::string name;
+    uint64_t count;
+    nanoseconds elapsed;
+    uint64_t allocated;
+};
+
+/// Latency samples of one operation, reported as percentiles.
+class latency
+{
+public:
+    void add(nanoseconds sample) { samples_.push_back(sample.count()); }
+    size_t size() const { return samples_.size(); }
+
+    /// The percentile in nanoseconds, percent is in [0, 100].
+    uint64_t percentile(double percent)
+    {
+        if (samples_.empty())
+            return 0;
+
+        std::sort(samples_.begin(), samples_.end());
+        const auto index = static_cast<size_t>(percent / 100 * (samples_.size() - 1));
+        return samples_[index];
+    }
+
+    void merge(const latency& other)
+    {
+        samples_.insert(samples_.end(), other.samples_.begin(), other.samples_.end());
+    }
+
+private:
+    std::vector<uint64_t> samples_;
+};
+
+inline void print(const phase& item, uint64_t units, const std::string& unit)
+{
+    const auto seconds = item.seconds();
+    std::cout << std::left << std::setw(16) << item.name
+        << std::right << std::fixed << std::setprecision(3)
+        << std::setw(12) << seconds << " s"
+        << std::setw(14) << (seconds > 0 ? units / seconds : 0) << " " << unit << "/s"
+        << std::setw(14) << (item.count ? item.allocated / item.count : 0) << " allocs/op"
+        << std::endl;
+}
+
+inline void print(const std::string& name, latency& samples, double seconds)
+{
+    std::cout << std::left << std::setw(16) << name
+        << std::right << std::fixed << std::setprecision(0)
+        << std::setw(12) << (seconds > 0 ? samples.size() / seconds : 0) << " op/s"
+        << "  p50 " << std::setw(8) << samples.percentile(50) << " ns"
+        << "  p90 " << std::setw(8) << samples.percentile(90) << " ns"
+        << "  p99 " << std::setw(8) << samples.percentile(99) << " ns"
+        << "  max " << std::setw(10) << samples.percentile(100) << " ns"
+        << std::endl;
+}
+
+} // namespace benchmark
+} // namespace libbitcoin
+
+#endif
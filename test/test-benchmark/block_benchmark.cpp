@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Replay a recorded range of blocks through block validation and the
+// database, reporting throughput, per phase timing and allocation counts.
+//
+// usage: block-benchmark <blocks-file> [--testnet] [--database <directory>]
+//                        [--count <blocks>]
+//
+// The blocks file holds consecutive blocks in wire format, the first one
+// building on the top of the database. Without --database a temporary
+// database is initialized with the genesis block, so the file must start
+// at height 1. The given database directory is modified by the replay,
+// pass a copy.
+
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/block_chain_impl.hpp>
+#include <metaverse/blockchain/block_detail.hpp>
+#include <metaverse/blockchain/settings.hpp>
+#include <metaverse/blockchain/validate_block_impl.hpp>
+#include <metaverse/consensus/miner.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::benchmark;
+
+static int usage()
+{
+    std::cerr << "usage: block-benchmark <blocks-file> [--testnet] "
+        "[--database <directory>] [--count <blocks>]" << std::endl;
+    return -1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+        return usage();
+
+    const std::string blocks_file(argv[1]);
+    boost::filesystem::path directory;
+    bool testnet = false;
+    uint64_t limit = max_uint64;
+
+    for (auto arg = 2; arg < argc; ++arg)
+    {
+        const std::string option(argv[arg]);
+        if (option == "--testnet")
+            testnet = true;
+        else if (option == "--database" && arg + 1 < argc)
+            directory = argv[++arg];
+        else if (option == "--count" && arg + 1 < argc)
+            limit = std::stoull(argv[++arg]);
+        else
+            return usage();
+    }
+
+    const auto temporary = directory.empty();
+    if (temporary)
+    {
+        directory = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("mvs-block-benchmark-%%%%-%%%%");
+        boost::filesystem::create_directories(directory);
+
+        const auto genesis = consensus::miner::create_genesis_block(!testnet);
+        if (!database::data_base::initialize(directory, *genesis))
+        {
+            std::cerr << "Failed to initialize database " << directory << std::endl;
+            return -1;
+        }
+    }
+
+    std::ifstream file(blocks_file, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Failed to open " << blocks_file << std::endl;
+        return -1;
+    }
+
+    blockchain::settings chain_settings;
+    chain_settings.use_testnet_rules = testnet;
+    const auto checkpoints = config::checkpoint::sort(chain_settings.checkpoints);
+
+    database::settings database_settings;
+    database_settings.directory = directory;
+
+    threadpool pool(1);
+    blockchain::block_chain_impl chain(pool, chain_settings, database_settings);
+    if (!chain.start())
+    {
+        std::cerr << "Failed to start database " << directory << std::endl;
+        return -1;
+    }
+
+    const auto stopped = []() { return false; };
+
+    phase parse("parse");
+    phase check("check_block");
+    phase accept("accept_block");
+    phase connect("connect_block");
+    phase push("push");
+    phase total("total");
+
+    uint64_t blocks = 0;
+    uint64_t transactions = 0;
+    uint64_t inputs = 0;
+    code ec;
+
+    while (blocks < limit && file.peek() != std::char_traits<char>::eof())
+    {
+        auto block = std::make_shared<message::block_message>();
+        if (!parse.measure([&]() { return block->from_data(version::level::maximum, file); }))
+        {
+            std::cerr << "Failed to parse block after " << blocks << " blocks" << std::endl;
+            break;
+        }
+
+        uint64_t top = 0;
+        chain.get_last_height(top);
+        const auto height = top + 1;
+
+        const auto detail = std::make_shared<blockchain::block_detail>(block);
+        const blockchain::block_detail::list orphan_chain{ detail };
+
+        ec = total.measure([&]()
+        {
+            // This follows organizer::verify, with each phase measured.
+            blockchain::validate_block_impl validate(chain, top, orphan_chain,
+                0, height, *block, testnet, checkpoints, stopped);
+
+            auto result = check.measure([&]() { return validate.check_block(chain); });
+            if (result)
+                return result;
+
+            validate.initialize_context();
+
+            result = accept.measure([&]() { return validate.accept_block(); });
+            if (result)
+                return result;
+
+            hash_digest err_tx;
+            result = connect.measure([&]() { return validate.connect_block(err_tx); });
+            if (result)
+                return result;
+
+            detail->set_height(height);
+            if (!push.measure([&]() { return chain.push(detail); }))
+                return code(error::operation_failed);
+
+            return result;
+        });
+
+        if (ec)
+        {
+            std::cerr << "Block [" << height << "] "
+                << encode_hash(block->header.hash()) << " failed: "
+                << ec.message() << std::endl;
+            break;
+        }
+
+        ++blocks;
+        transactions += block->transactions.size();
+        for (const auto& tx : block->transactions)
+            inputs += tx.inputs.size();
+    }
+
+    chain.stop();
+    chain.close();
+
+    if (temporary)
+        boost::filesystem::remove_all(directory);
+
+    const auto seconds = total.seconds();
+    std::cout << "blocks " << blocks << ", transactions " << transactions
+        << ", inputs " << inputs << std::endl;
+    std::cout << "blocks/sec " << (seconds > 0 ? blocks / seconds : 0)
+        << ", inputs/sec " << (seconds > 0 ? inputs / seconds : 0) << std::endl;
+
+    print(parse, blocks, "blocks");
+    print(check, blocks, "blocks");
+    print(accept, blocks, "blocks");
+    print(connect, inputs, "inputs");
+    print(push, blocks, "blocks");
+    print(total, blocks, "blocks");
+
+    return ec ? -1 : 0;
+}
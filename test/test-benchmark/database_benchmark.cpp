@@ -0,0 +1,456 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measure the database primitives on temporary files: memory_map growth,
+// record_manager, slab_manager, record_hash_table, slab_hash_table and
+// record_multimap, plus record_hash_table reads under a concurrent writer.
+//
+// usage: database-benchmark [--keys <count>] [--buckets <count>]
+//                           [--rows <per key>] [--readers <threads>]
+//                           [--reads <per write>] [--directory <directory>]
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/database/memory/memory_map.hpp>
+#include <metaverse/database/primitives/record_hash_table.hpp>
+#include <metaverse/database/primitives/record_list.hpp>
+#include <metaverse/database/primitives/record_manager.hpp>
+#include <metaverse/database/primitives/record_multimap.hpp>
+#include <metaverse/database/primitives/record_multimap_iterable.hpp>
+#include <metaverse/database/primitives/record_multimap_iterator.hpp>
+#include <metaverse/database/primitives/slab_hash_table.hpp>
+#include <metaverse/database/primitives/slab_manager.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::database;
+using namespace libbitcoin::benchmark;
+using boost::filesystem::path;
+
+struct options
+{
+    size_t keys = 1000000;
+    size_t buckets = 1000003;
+    size_t rows = 8;
+    size_t readers = 4;
+    size_t reads = 10;
+    path directory;
+};
+
+static int usage()
+{
+    std::cerr << "usage: database-benchmark [--keys <count>] "
+        "[--buckets <count>] [--rows <per key>] [--readers <threads>] "
+        "[--reads <per write>] [--directory <directory>]" << std::endl;
+    return -1;
+}
+
+// Deterministic, well distributed keys without hashing cost in the loops.
+static uint64_t mix(uint64_t value)
+{
+    value += 0x9e3779b97f4a7c15;
+    value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9;
+    value = (value ^ (value >> 27)) * 0x94d049bb133111eb;
+    return value ^ (value >> 31);
+}
+
+template <typename Key>
+static std::vector<Key> make_keys(size_t count, uint64_t seed)
+{
+    std::vector<Key> keys(count);
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto& key = keys[index];
+        for (size_t offset = 0; offset < key.size(); offset += sizeof(uint64_t))
+        {
+            const auto word = mix(seed + index * 4 + offset);
+            std::memcpy(key.data() + offset, &word,
+                std::min(sizeof(uint64_t), key.size() - offset));
+        }
+    }
+
+    return keys;
+}
+
+static void touch(const path& file)
+{
+    bc::ofstream stream(file.string());
+    stream.write("X", 1);
+}
+
+// Time each call of handler(index) for count iterations.
+template <typename Handler>
+static double sample(size_t count, latency& samples, Handler handler)
+{
+    const auto start = steady_clock::now();
+    for (size_t index = 0; index < count; ++index)
+    {
+        const auto begin = steady_clock::now();
+        handler(index);
+        samples.add(std::chrono::duration_cast<nanoseconds>(
+            steady_clock::now() - begin));
+    }
+
+    return std::chrono::duration<double>(steady_clock::now() - start).count();
+}
+
+template <typename Handler>
+static void run(const std::string& name, size_t count, Handler handler)
+{
+    latency samples;
+    const auto seconds = sample(count, samples, handler);
+    print(name, samples, seconds);
+}
+
+static void bench_memory_map(const options& config)
+{
+    const auto file = config.directory / "memory_map";
+    touch(file);
+    memory_map map(file);
+    map.start();
+
+    // Grow the way the record managers do, one record at a time.
+    BC_CONSTEXPR size_t record = 64;
+    size_t remaps = 0;
+    size_t previous = map.size();
+
+    run("reserve", config.keys, [&](size_t index)
+    {
+        map.reserve((index + 1) * record);
+        const auto size = map.size();
+        remaps += size != previous ? 1 : 0;
+        previous = size;
+    });
+
+    std::cout << "  remaps " << remaps << ", file size " << map.size()
+        << std::endl;
+
+    run("access", config.keys, [&](size_t index)
+    {
+        const auto memory = map.access();
+        const auto data = REMAP_ADDRESS(memory);
+        data[(index * record) % previous] = static_cast<uint8_t>(index);
+    });
+
+    map.close();
+}
+
+static void bench_managers(const options& config)
+{
+    const auto records_file = config.directory / "records";
+    touch(records_file);
+    memory_map records_map(records_file);
+    records_map.start();
+    records_map.resize(minimum_records_size);
+    record_manager records(records_map, 0, 64);
+    records.create();
+    records.start();
+
+    run("record new", config.keys, [&](size_t)
+    {
+        records.new_records(1);
+    });
+
+    records.sync();
+    run("record get", config.keys, [&](size_t index)
+    {
+        const auto memory = records.get(mix(index) % config.keys);
+        REMAP_ADDRESS(memory)[0] = 0;
+    });
+
+    const auto slabs_file = config.directory / "slabs";
+    touch(slabs_file);
+    memory_map slabs_map(slabs_file);
+    slabs_map.start();
+    slabs_map.resize(minimum_slabs_size);
+    slab_manager slabs(slabs_map, 0);
+    slabs.create();
+    slabs.start();
+
+    std::vector<file_offset> positions(config.keys);
+    run("slab new", config.keys, [&](size_t index)
+    {
+        positions[index] = slabs.new_slab(32 + mix(index) % 224);
+    });
+
+    slabs.sync();
+    run("slab get", config.keys, [&](size_t index)
+    {
+        const auto memory = slabs.get(positions[mix(index) % config.keys]);
+        REMAP_ADDRESS(memory)[0] = 0;
+    });
+
+    records_map.close();
+    slabs_map.close();
+}
+
+static void bench_record_hash_table(const options& config,
+    const std::vector<hash_digest>& keys,
+    const std::vector<hash_digest>& missing)
+{
+    const auto file = config.directory / "record_hash_table";
+    const auto header_size = record_hash_table_header_size(config.buckets);
+    touch(file);
+    memory_map map(file);
+    map.start();
+    map.resize(header_size + minimum_records_size);
+
+    record_hash_table_header header(map, config.buckets);
+    record_manager manager(map, header_size,
+        hash_table_record_size<hash_digest>(sizeof(uint64_t)));
+    header.create();
+    manager.create();
+    header.start();
+    manager.start();
+    record_hash_table<hash_digest> table(header, manager);
+
+    run("record store", keys.size(), [&](size_t index)
+    {
+        table.store(keys[index], [index](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_8_bytes_little_endian(index);
+        });
+    });
+
+    manager.sync();
+    run("record find", keys.size(), [&](size_t index)
+    {
+        table.find(keys[mix(index) % keys.size()]);
+    });
+
+    run("record miss", missing.size(), [&](size_t index)
+    {
+        table.find(missing[index]);
+    });
+
+    // Readers contend with one writer appending new keys.
+    const auto writes = keys.size() / std::max<size_t>(config.reads, 1);
+    const auto added = make_keys<hash_digest>(writes, 3);
+    const auto reads = writes * config.reads / std::max<size_t>(config.readers, 1);
+    std::vector<latency> read_samples(config.readers);
+    std::vector<std::thread> readers;
+
+    const auto start = steady_clock::now();
+    for (size_t reader = 0; reader < config.readers; ++reader)
+    {
+        readers.emplace_back([&, reader]()
+        {
+            sample(reads, read_samples[reader], [&](size_t index)
+            {
+                table.find(keys[mix(reader * reads + index) % keys.size()]);
+            });
+        });
+    }
+
+    latency write_samples;
+    const auto write_seconds = sample(writes, write_samples, [&](size_t index)
+    {
+        table.store(added[index], [index](memory_ptr data)
+        {
+            auto serial = make_serializer(REMAP_ADDRESS(data));
+            serial.write_8_bytes_little_endian(index);
+        });
+    });
+
+    for (auto& thread: readers)
+        thread.join();
+
+    const auto seconds = std::chrono::duration<double>(
+        steady_clock::now() - start).count();
+
+    latency all_reads;
+    for (const auto& samples: read_samples)
+        all_reads.merge(samples);
+
+    std::cout << "concurrent, " << config.readers << " readers, "
+        << config.reads << " reads per write" << std::endl;
+    print("  reads", all_reads, seconds);
+    print("  writes", write_samples, write_seconds);
+
+    map.close();
+}
+
+static void bench_slab_hash_table(const options& config,
+    const std::vector<hash_digest>& keys,
+    const std::vector<hash_digest>& missing)
+{
+    const auto file = config.directory / "slab_hash_table";
+    const auto header_size = slab_hash_table_header_size(config.buckets);
+    touch(file);
+    memory_map map(file);
+    map.start();
+    map.resize(header_size + minimum_slabs_size);
+
+    slab_hash_table_header header(map, config.buckets);
+    slab_manager manager(map, header_size);
+    header.create();
+    manager.create();
+    header.start();
+    manager.start();
+    slab_hash_table<hash_digest> table(header, manager);
+
+    // Transaction sized values.
+    run("slab store", keys.size(), [&](size_t index)
+    {
+        const auto size = 128 + mix(index) % 384;
+        table.store(keys[index], [size](memory_ptr data)
+        {
+            std::memset(REMAP_ADDRESS(data), 0, size);
+        }, size);
+    });
+
+    manager.sync();
+    run("slab find", keys.size(), [&](size_t index)
+    {
+        table.find(keys[mix(index) % keys.size()]);
+    });
+
+    run("slab miss", missing.size(), [&](size_t index)
+    {
+        table.find(missing[index]);
+    });
+
+    map.close();
+}
+
+static void bench_record_multimap(const options& config)
+{
+    // History database layout, short_hash keys with multiple rows each.
+    BC_CONSTEXPR size_t value_size = 1 + 36 + 4 + 8;
+    const auto lookup_file = config.directory / "multimap_lookup";
+    const auto rows_file = config.directory / "multimap_rows";
+    const auto header_size = record_hash_table_header_size(config.buckets);
+    touch(lookup_file);
+    touch(rows_file);
+
+    memory_map lookup_map(lookup_file);
+    memory_map rows_map(rows_file);
+    lookup_map.start();
+    rows_map.start();
+    lookup_map.resize(header_size + minimum_records_size);
+    rows_map.resize(minimum_records_size);
+
+    record_hash_table_header header(lookup_map, config.buckets);
+    record_manager lookup_manager(lookup_map, header_size,
+        hash_table_multimap_record_size<short_hash>());
+    record_manager rows_manager(rows_map, 0,
+        hash_table_record_size<hash_digest>(value_size));
+    header.create();
+    lookup_manager.create();
+    rows_manager.create();
+    header.start();
+    lookup_manager.start();
+    rows_manager.start();
+
+    record_hash_table<short_hash> table(header, lookup_manager);
+    record_list rows(rows_manager);
+    record_multimap<short_hash> multimap(table, rows);
+
+    const auto addresses = std::max<size_t>(config.keys / config.rows, 1);
+    const auto keys = make_keys<short_hash>(addresses, 5);
+
+    run("multimap add", addresses * config.rows, [&](size_t index)
+    {
+        multimap.add_row(keys[index % addresses], [](memory_ptr data)
+        {
+            std::memset(REMAP_ADDRESS(data), 0, value_size);
+        });
+    });
+
+    lookup_manager.sync();
+    rows_manager.sync();
+
+    size_t found = 0;
+    run("multimap read", addresses, [&](size_t index)
+    {
+        const auto start = multimap.lookup(keys[mix(index) % addresses]);
+        for (const auto row: record_multimap_iterable(rows, start))
+        {
+            const auto record = rows.get(row);
+            found += REMAP_ADDRESS(record)[0] == 0 ? 1 : 0;
+        }
+    });
+
+    std::cout << "  " << found / addresses << " rows per read" << std::endl;
+
+    lookup_map.close();
+    rows_map.close();
+}
+
+int main(int argc, char* argv[])
+{
+    options config;
+
+    for (auto arg = 1; arg < argc; ++arg)
+    {
+        const std::string option(argv[arg]);
+        if (arg + 1 >= argc)
+            return usage();
+
+        const std::string value(argv[++arg]);
+        if (option == "--directory")
+            config.directory = value;
+        else if (option == "--keys")
+            config.keys = std::stoull(value);
+        else if (option == "--buckets")
+            config.buckets = std::stoull(value);
+        else if (option == "--rows")
+            config.rows = std::stoull(value);
+        else if (option == "--readers")
+            config.readers = std::stoull(value);
+        else if (option == "--reads")
+            config.reads = std::stoull(value);
+        else
+            return usage();
+    }
+
+    if (config.keys == 0 || config.buckets == 0 || config.rows == 0)
+        return usage();
+
+    const auto temporary = config.directory.empty();
+    if (temporary)
+        config.directory = boost::filesystem::temp_directory_path() /
+            boost::filesystem::unique_path("mvs-database-benchmark-%%%%-%%%%");
+
+    boost::filesystem::create_directories(config.directory);
+
+    std::cout << "keys " << config.keys << ", buckets " << config.buckets
+        << ", rows per key " << config.rows << std::endl;
+
+    const auto keys = make_keys<hash_digest>(config.keys, 1);
+    const auto missing = make_keys<hash_digest>(config.keys, 2);
+
+    bench_memory_map(config);
+    bench_managers(config);
+    bench_record_hash_table(config, keys, missing);
+    bench_slab_hash_table(config, keys, missing);
+    bench_record_multimap(config);
+
+    if (temporary)
+        boost::filesystem::remove_all(config.directory);
+
+    return 0;
+}
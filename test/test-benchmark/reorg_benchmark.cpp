@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measure a reorganization of the database top: pop a range of blocks using
+// their undo journals, push them back, then pop them again with the journals
+// removed so the rows are derived from the transactions as before.
+//
+// usage: reorg-benchmark <blocks-file> [--testnet] [--depth <blocks>]
+//
+// The blocks file holds consecutive blocks in wire format starting at height
+// 1. They are written to a temporary database without validation.
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/consensus/miner.hpp>
+#include <metaverse/database/data_base.hpp>
+#include <metaverse/database/settings.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::benchmark;
+
+static int usage()
+{
+    std::cerr << "usage: reorg-benchmark <blocks-file> [--testnet] "
+        "[--depth <blocks>]" << std::endl;
+    return -1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+        return usage();
+
+    const std::string blocks_file(argv[1]);
+    bool testnet = false;
+    size_t depth = 100;
+
+    for (auto arg = 2; arg < argc; ++arg)
+    {
+        const std::string option(argv[arg]);
+        if (option == "--testnet")
+            testnet = true;
+        else if (option == "--depth" && arg + 1 < argc)
+            depth = std::stoull(argv[++arg]);
+        else
+            return usage();
+    }
+
+    std::ifstream file(blocks_file, std::ios::binary);
+    if (!file)
+    {
+        std::cerr << "Failed to open " << blocks_file << std::endl;
+        return -1;
+    }
+
+    const auto directory = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("mvs-reorg-benchmark-%%%%-%%%%");
+    boost::filesystem::create_directories(directory);
+
+    const auto genesis = consensus::miner::create_genesis_block(!testnet);
+    if (!database::data_base::initialize(directory, *genesis))
+    {
+        std::cerr << "Failed to initialize database " << directory << std::endl;
+        return -1;
+    }
+
+    database::settings settings;
+    settings.directory = directory;
+    database::data_base database(settings);
+    if (!database.start())
+    {
+        std::cerr << "Failed to start database " << directory << std::endl;
+        return -1;
+    }
+
+    size_t blocks = 0;
+    while (file.peek() != std::char_traits<char>::eof())
+    {
+        chain::block block;
+        if (!block.from_data(file))
+        {
+            std::cerr << "Failed to parse block after " << blocks << " blocks" << std::endl;
+            break;
+        }
+
+        database.push(block);
+        ++blocks;
+    }
+
+    if (blocks < depth)
+    {
+        std::cerr << "The depth exceeds the " << blocks << " blocks read" << std::endl;
+        database.stop();
+        boost::filesystem::remove_all(directory);
+        return -1;
+    }
+
+    phase journal("pop journal");
+    phase push("push");
+    phase derived("pop derived");
+
+    uint64_t transactions = 0;
+    std::vector<chain::block> popped;
+    popped.reserve(depth);
+
+    journal.measure([&]()
+    {
+        for (size_t block = 0; block < depth; ++block)
+            popped.push_back(database.pop());
+    });
+
+    for (const auto& block: popped)
+        transactions += block.transactions.size();
+
+    push.measure([&]()
+    {
+        for (auto block = popped.rbegin(); block != popped.rend(); ++block)
+            database.push(*block);
+    });
+
+    // Blocks without a journal are popped the way they were before it.
+    for (const auto& block: popped)
+        database.undos.remove(block.header.hash());
+
+    popped.clear();
+    derived.measure([&]()
+    {
+        for (size_t block = 0; block < depth; ++block)
+            popped.push_back(database.pop());
+    });
+
+    database.stop();
+    database.close();
+    boost::filesystem::remove_all(directory);
+
+    std::cout << "depth " << depth << ", transactions " << transactions
+        << std::endl;
+
+    print(journal, depth, "blocks");
+    print(push, depth, "blocks");
+    print(derived, depth, "blocks");
+
+    return 0;
+}
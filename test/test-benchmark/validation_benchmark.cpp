@@ -0,0 +1,179 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Measure the context free block checks on a synthetic block and fail when
+// any of them allocates more per call than its budget, so that a by-value
+// copy of transactions or outputs in these loops shows up as a regression.
+//
+// usage: validation-benchmark [--transactions <count>] [--rounds <count>]
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/validate_block.hpp>
+#include "benchmark.hpp"
+
+using namespace libbitcoin;
+using namespace libbitcoin::benchmark;
+using namespace libbitcoin::chain;
+
+// Expose the protected static checks, this type is never constructed.
+struct checks
+  : public blockchain::validate_block
+{
+    using validate_block::check_coinbases;
+    using validate_block::stopped_callback;
+    using validate_block::is_distinct_tx_set;
+    using validate_block::legacy_sigops_count;
+};
+
+static int usage()
+{
+    std::cerr << "usage: validation-benchmark [--transactions <count>] "
+        "[--rounds <count>]" << std::endl;
+    return -1;
+}
+
+static operation push(size_t size, uint8_t fill)
+{
+    operation op;
+    op.data = data_chunk(size, fill);
+    op.code = data_to_opcode(op.data);
+    return op;
+}
+
+static output pay(uint64_t value, uint8_t fill)
+{
+    output out;
+    out.value = value;
+    out.script.operations = operation::to_pay_key_hash_pattern(
+        short_hash{ { fill } });
+    out.attach_data = attachment(ETP_TYPE, 1, etp(value));
+    return out;
+}
+
+// A coinbase followed by two-in two-out key hash payments.
+static transaction::list make_transactions(size_t count)
+{
+    transaction::list transactions(count);
+
+    auto& coinbase = transactions.front();
+    coinbase.inputs.resize(1);
+    coinbase.inputs[0].previous_output = { null_hash, max_uint32 };
+    coinbase.inputs[0].script.operations = { push(8, 0) };
+    coinbase.outputs = { pay(300000000, 0) };
+
+    for (size_t index = 1; index < count; ++index)
+    {
+        auto& tx = transactions[index];
+        const auto fill = static_cast<uint8_t>(index);
+        tx.version = 1;
+        tx.inputs.resize(2);
+
+        for (auto& input: tx.inputs)
+        {
+            input.previous_output = { hash_digest{ { fill } }, 0 };
+            input.script.operations = { push(72, fill), push(33, fill) };
+            input.sequence = max_uint32;
+        }
+
+        // Distinct values keep the transaction hashes distinct.
+        tx.outputs = { pay(index, fill), pay(index + 1, fill) };
+    }
+
+    return transactions;
+}
+
+int main(int argc, char* argv[])
+{
+    size_t count = 2000;
+    size_t rounds = 100;
+
+    for (auto arg = 1; arg < argc; ++arg)
+    {
+        const std::string option(argv[arg]);
+        if (arg + 1 >= argc)
+            return usage();
+
+        const std::string value(argv[++arg]);
+        if (option == "--transactions")
+            count = std::stoull(value);
+        else if (option == "--rounds")
+            rounds = std::stoull(value);
+        else
+            return usage();
+    }
+
+    if (count == 0 || rounds == 0)
+        return usage();
+
+    const auto transactions = make_transactions(count);
+
+    // Hashes are cached on first use, as they are by deserialization checks.
+    for (const auto& tx: transactions)
+        tx.hash();
+
+    phase coinbases("check_coinbases");
+    phase sigops("sigops");
+    phase distinct("distinct_tx_set");
+    phase merkle("merkle_root");
+
+    const checks::stopped_callback stopped = []() { return false; };
+
+    auto valid = true;
+    for (size_t round = 0; round < rounds; ++round)
+    {
+        valid &= !coinbases.measure([&]() { return checks::check_coinbases(transactions, stopped); });
+        valid &= sigops.measure([&]() { return checks::legacy_sigops_count(transactions); }) > 0;
+        valid &= distinct.measure([&]() { return checks::is_distinct_tx_set(transactions); });
+        valid &= merkle.measure([&]() { return block::generate_merkle_root(transactions); }) != null_hash;
+    }
+
+    std::cout << "transactions " << count << ", rounds " << rounds << std::endl;
+    print(coinbases, rounds * count, "txs");
+    print(sigops, rounds * count, "txs");
+    print(distinct, rounds * count, "txs");
+    print(merkle, rounds * count, "txs");
+
+    if (!valid)
+    {
+        std::cerr << "The synthetic block failed its checks." << std::endl;
+        return -1;
+    }
+
+    // Allowed allocations per call, independent of the transaction count.
+    const auto within = [](const phase& item, uint64_t budget)
+    {
+        const auto per_call = item.allocated / item.count;
+        if (per_call <= budget)
+            return true;
+
+        std::cerr << item.name << " made " << per_call
+            << " allocations per call, the budget is " << budget << std::endl;
+        return false;
+    };
+
+    auto passed = within(coinbases, 0);
+    passed &= within(sigops, 0);
+    passed &= within(distinct, 1);
+    passed &= within(merkle, 1);
+    return passed ? 0 : -1;
+}
@@ -170,6 +170,64 @@ BOOST_AUTO_TEST_CASE(push_attachemnt_asset_transfer)
     BOOST_REQUIRE(true);
 }
 
+// A pop replays the journal the push stored, leaving the rows as before.
+BOOST_AUTO_TEST_CASE(push_pop_undo_journal)
+{
+	const boost::filesystem::path directory("undo-database");
+	boost::filesystem::remove_all(directory);
+	boost::filesystem::create_directories(directory);
+
+	const auto genesis = consensus::miner::create_genesis_block(true);
+	BOOST_REQUIRE(data_base::initialize(directory, *genesis));
+
+	database::settings db_settings;
+	db_settings.directory = directory;
+	data_base db(db_settings);
+	BOOST_REQUIRE(db.start());
+
+	const short_hash key{ { 0x01, 0x02, 0x03 } };
+	output pay;
+	pay.value = 1000;
+	pay.script.operations = operation::to_pay_key_hash_pattern(key);
+
+	input coinbase_input;
+	coinbase_input.previous_output = output_point{ null_hash, max_uint32 };
+	coinbase_input.sequence = max_uint32;
+
+	const output_point spent{ genesis->transactions.front().hash(), 0 };
+	input spend_input;
+	spend_input.previous_output = spent;
+	spend_input.sequence = max_uint32;
+
+	block next;
+	next.header.previous_block_hash = genesis->header.hash();
+	next.header.number = 1;
+	next.transactions.push_back(transaction(1, 0, { coinbase_input }, { pay }));
+	next.transactions.push_back(transaction(1, 0, { spend_input }, { pay }));
+	const auto block_hash = next.header.hash();
+
+	const auto history = db.history.get(key, 0, 0).size();
+
+	db.push(next, 1);
+	BOOST_REQUIRE(db.spends.get(spent).valid);
+	BOOST_REQUIRE(db.undos.get(block_hash));
+	BOOST_REQUIRE_EQUAL(db.history.get(key, 0, 0).size(), history + 2);
+
+	const auto popped = db.pop();
+	BOOST_REQUIRE(popped.header.hash() == block_hash);
+	BOOST_REQUIRE(!db.spends.get(spent).valid);
+	BOOST_REQUIRE(!db.undos.get(block_hash));
+	BOOST_REQUIRE_EQUAL(db.history.get(key, 0, 0).size(), history);
+
+	size_t top;
+	BOOST_REQUIRE(db.blocks.top(top));
+	BOOST_REQUIRE_EQUAL(top, 0u);
+
+	db.stop();
+	db.close();
+	boost::filesystem::remove_all(directory);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
 
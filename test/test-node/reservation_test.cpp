@@ -0,0 +1,166 @@
+/**
+ * Copyright (c) 2016-2018 metaverse core developers (see MVS-AUTHORS)
+ *
+ * This file is part of metaverse.
+ *
+ * metaverse is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License with
+ * additional permissions to the one published by the Free Software
+ * Foundation, either version 3 of the License, or (at your option)
+ * any later version. For more information see LICENSE.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <future>
+#include <memory>
+#include <boost/test/unit_test.hpp>
+#include <metaverse/bitcoin.hpp>
+#include <metaverse/blockchain/simple_chain.hpp>
+#include <metaverse/node/settings.hpp>
+#include <metaverse/node/utility/header_queue.hpp>
+#include <metaverse/node/utility/reservation.hpp>
+#include <metaverse/node/utility/reservations.hpp>
+
+using namespace libbitcoin;
+using namespace libbitcoin::chain;
+using namespace libbitcoin::node;
+
+BOOST_AUTO_TEST_SUITE(reservation_tests)
+
+// An empty chain that accepts every import.
+class empty_chain
+  : public blockchain::simple_chain
+{
+public:
+	bool get_gap_range(uint64_t&, uint64_t&) const { return false; }
+	bool get_next_gap(uint64_t&, uint64_t) const { return false; }
+	bool get_difficulty(u256&, uint64_t) const { return false; }
+	bool get_header(header&, uint64_t) const { return false; }
+	bool get_height(uint64_t&, const hash_digest&) const { return false; }
+	bool get_last_height(uint64_t&) const { return false; }
+	bool get_outpoint_transaction(hash_digest&, const output_point&) const { return false; }
+	bool get_transaction(transaction&, uint64_t&, const hash_digest&) const { return false; }
+	bool import(block::ptr, uint64_t) { return true; }
+	bool push(blockchain::block_detail::ptr) { return true; }
+	bool pop_from(blockchain::block_detail::list&, uint64_t) { return false; }
+};
+
+// Linked empty blocks from height zero, the first with a bad merkle root.
+static block::ptr_list make_blocks(size_t count)
+{
+	block::ptr_list blocks;
+	hash_digest previous = null_hash;
+
+	for (size_t height = 0; height < count; ++height)
+	{
+		const auto item = std::make_shared<block>();
+		item->header.number = height;
+		item->header.previous_block_hash = previous;
+		item->header.merkle = block::generate_merkle_root(item->transactions);
+
+		if (height == 0)
+			item->header.merkle[0] ^= 1;
+
+		previous = item->header.hash();
+		blocks.push_back(item);
+	}
+
+	return blocks;
+}
+
+static void enqueue(header_queue& hashes, const block::ptr_list& blocks)
+{
+	hashes.initialize(blocks.front()->header.hash(), 0);
+
+	const auto message = std::make_shared<message::headers>();
+	for (auto it = blocks.begin() + 1; it != blocks.end(); ++it)
+		message->elements.push_back((*it)->header);
+
+	BOOST_REQUIRE(hashes.enqueue(message));
+}
+
+static void flush(reservations& table)
+{
+	std::promise<void> flushed;
+	table.flush([&flushed]() { flushed.set_value(); });
+	flushed.get_future().wait();
+}
+
+BOOST_AUTO_TEST_CASE(reservation__import__rejected_on_stopped_row__restored_to_live_row)
+{
+	// Without threads the merkle checks wait until the rows have moved on.
+	threadpool pool(0);
+	empty_chain chain;
+	const config::checkpoint::list checkpoints;
+	header_queue hashes(checkpoints);
+	node::settings configuration;
+	configuration.download_connections = 2;
+
+	const auto blocks = make_blocks(4);
+	enqueue(hashes, blocks);
+	reservations table(pool, hashes, chain, configuration);
+	const auto rows = table.table();
+	BOOST_REQUIRE_EQUAL(rows.size(), 2u);
+
+	// Heights are dealt in turn: row 0 holds 0 and 2, row 1 holds 1 and 3.
+	const auto first = rows[0];
+	const auto second = rows[1];
+	first->import(blocks[0]);
+	second->import(blocks[1]);
+	second->import(blocks[3]);
+
+	// The second row took the last hash of the first, which then stopped.
+	BOOST_REQUIRE(first->stopped());
+	BOOST_REQUIRE(first->empty());
+	BOOST_REQUIRE_EQUAL(second->size(), 1u);
+
+	pool.spawn(1);
+	flush(table);
+
+	BOOST_REQUIRE(first->toggle_rejected());
+	BOOST_REQUIRE(first->empty());
+	BOOST_REQUIRE_EQUAL(second->size(), 2u);
+	BOOST_REQUIRE(!table.incomplete());
+
+	pool.shutdown();
+	pool.join();
+}
+
+BOOST_AUTO_TEST_CASE(reservation__import__rejected_with_all_rows_stopped__incomplete)
+{
+	threadpool pool(0);
+	empty_chain chain;
+	const config::checkpoint::list checkpoints;
+	header_queue hashes(checkpoints);
+	node::settings configuration;
+	configuration.download_connections = 1;
+
+	const auto blocks = make_blocks(2);
+	enqueue(hashes, blocks);
+	reservations table(pool, hashes, chain, configuration);
+	const auto rows = table.table();
+	BOOST_REQUIRE_EQUAL(rows.size(), 1u);
+
+	const auto row = rows.front();
+	row->import(blocks[0]);
+	row->import(blocks[1]);
+	BOOST_REQUIRE(row->stopped());
+
+	pool.spawn(1);
+	flush(table);
+
+	BOOST_REQUIRE(row->toggle_rejected());
+	BOOST_REQUIRE(row->empty());
+	BOOST_REQUIRE(table.incomplete());
+
+	pool.shutdown();
+	pool.join();
+}
+
+BOOST_AUTO_TEST_SUITE_END()